@@ -0,0 +1,214 @@
+#include <JuceHeader.h>
+#include <iostream>
+#include <map>
+#include "../../Source/PluginProcessor.h"
+
+// Headless renderer: applies a breakpoint file to audio files through PanningProcessor,
+// one file per thread-pool job, writing stereo WAVs next to each other in the output folder.
+//
+// Usage: BatchRender --curve=pan.txt [--law=linear|power] [--out=dir] [--block=65536]
+//                    [--bits=16|24|32] [--threads=N] input1.wav input2.aiff ...
+
+namespace {
+    struct RenderSettings {
+        juce::String curveText;
+        bool constantPower = true;
+        int blockSize = 65536;
+        int bitsPerSample = 24;
+        juce::File outputDirectory;
+    };
+
+    struct RenderTotals {
+        std::atomic<int> rendered{ 0 };
+        std::atomic<int> failed{ 0 };
+        std::atomic<juce::int64> samplesRendered{ 0 };
+        std::atomic<juce::int64> sampleRateSum{ 0 };
+        juce::CriticalSection logLock;
+
+        void log(const juce::String& message) {
+            const juce::ScopedLock sl(logLock);
+            std::cout << message << std::endl;
+        }
+    };
+
+    class RenderJob : public juce::ThreadPoolJob {
+    public:
+        RenderJob(const juce::File& input, const juce::File& output, const RenderSettings& renderSettings,
+                  juce::AudioFormatManager& formats, RenderTotals& renderTotals)
+            : juce::ThreadPoolJob(input.getFileName()), inputFile(input), outputFile(output), settings(renderSettings),
+              formatManager(formats), totals(renderTotals) {}
+
+        JobStatus runJob() override {
+            if (render()) {
+                ++totals.rendered;
+            }
+            else {
+                ++totals.failed;
+            }
+            return jobHasFinished;
+        }
+
+    private:
+        juce::File inputFile, outputFile;
+        const RenderSettings& settings;
+        juce::AudioFormatManager& formatManager;
+        RenderTotals& totals;
+
+        bool render() {
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(inputFile));
+            if (reader == nullptr) {
+                totals.log("Can't read " + inputFile.getFullPathName());
+                return false;
+            }
+
+            const int numInputs = reader->numChannels == 1 ? 1 : 2;
+            const double sampleRate = reader->sampleRate;
+
+            PanningProcessor processor;
+            juce::AudioProcessor::BusesLayout layout;
+            layout.inputBuses.add(numInputs == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo());
+            layout.inputBuses.add(juce::AudioChannelSet::disabled());
+            layout.outputBuses.add(juce::AudioChannelSet::stereo());
+            if (!processor.setBusesLayout(layout)) {
+                totals.log("Unsupported channel layout: " + inputFile.getFullPathName());
+                return false;
+            }
+
+            processor.setBreakpointText(settings.curveText);
+            processor.params.getParameter("sync")->setValueNotifyingHost(1.0f);
+            processor.params.getParameter("law")->setValueNotifyingHost(settings.constantPower ? 1.0f : 0.0f);
+            processor.setNonRealtime(true);
+            processor.setRateAndBufferSizeDetails(sampleRate, settings.blockSize);
+            processor.prepareToPlay(sampleRate, settings.blockSize);
+
+            outputFile.deleteFile();
+            std::unique_ptr<juce::OutputStream> stream(outputFile.createOutputStream());
+            if (stream == nullptr) {
+                totals.log("Can't write " + outputFile.getFullPathName());
+                return false;
+            }
+
+            juce::WavAudioFormat wavFormat;
+            std::unique_ptr<juce::AudioFormatWriter> writer(
+                wavFormat.createWriterFor(stream.get(), sampleRate, 2, settings.bitsPerSample, {}, 0));
+            if (writer == nullptr) {
+                totals.log("Can't create a WAV writer for " + outputFile.getFullPathName());
+                return false;
+            }
+            stream.release(); // now owned by the writer
+
+            juce::AudioBuffer<float> buffer(2, settings.blockSize);
+            juce::MidiBuffer midi;
+            const juce::int64 length = reader->lengthInSamples;
+
+            for (juce::int64 position = 0; position < length; position += settings.blockSize) {
+                if (shouldExit()) return false;
+
+                const int numSamples = static_cast<int>(juce::jmin<juce::int64>(settings.blockSize, length - position));
+                buffer.setSize(2, numSamples, false, false, true);
+                buffer.clear();
+                reader->read(&buffer, 0, numSamples, position, true, numInputs > 1);
+
+                processor.processBlock(buffer, midi);
+                writer->writeFromAudioSampleBuffer(buffer, 0, numSamples);
+            }
+
+            processor.releaseResources();
+            totals.samplesRendered += length;
+            totals.sampleRateSum += static_cast<juce::int64>(sampleRate);
+            totals.log("Rendered " + outputFile.getFullPathName());
+            return true;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE(RenderJob)
+    };
+
+    juce::File getOutputFile(const juce::File& input, const RenderSettings& settings) {
+        return settings.outputDirectory.getChildFile(input.getFileNameWithoutExtension() + "_panned.wav");
+    }
+
+    void printUsage() {
+        std::cout << "Usage: BatchRender --curve=pan.txt [--law=linear|power] [--out=dir] [--block=65536]\n"
+                     "                   [--bits=16|24|32] [--threads=N] input files..." << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // PanningProcessor's parameter tree expects the message manager to exist
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (!args.containsOption("--curve")) {
+        printUsage();
+        return 1;
+    }
+
+    juce::File curveFile = args.getFileForOption("--curve");
+    if (!curveFile.existsAsFile()) {
+        std::cout << "Breakpoint file not found: " << curveFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    RenderSettings settings;
+    settings.curveText = curveFile.loadFileAsString();
+    settings.constantPower = !args.getValueForOption("--law").equalsIgnoreCase("linear");
+    settings.blockSize = juce::jlimit(32, 1 << 20, args.containsOption("--block") ? args.getValueForOption("--block").getIntValue() : 65536);
+    settings.bitsPerSample = args.containsOption("--bits") ? args.getValueForOption("--bits").getIntValue() : 24;
+    settings.outputDirectory = args.containsOption("--out") ? args.getFileForOption("--out")
+                                                            : juce::File::getCurrentWorkingDirectory();
+    settings.outputDirectory.createDirectory();
+
+    const int numThreads = args.containsOption("--threads") ? juce::jmax(1, args.getValueForOption("--threads").getIntValue())
+                                                            : juce::SystemStats::getNumCpus();
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    juce::Array<juce::File> inputs;
+    for (const auto& arg : args.arguments) {
+        if (!arg.isOption())
+            inputs.add(arg.resolveAsFile());
+    }
+    if (inputs.isEmpty()) {
+        printUsage();
+        return 1;
+    }
+
+    // Inputs with the same name in different folders would overwrite each other's output.
+    // Compared without case, since the output folder may not tell them apart either.
+    std::map<juce::String, juce::File> inputForOutput;
+    for (const auto& input : inputs) {
+        const auto key = getOutputFile(input, settings).getFullPathName().toLowerCase();
+        const auto clash = inputForOutput.find(key);
+        if (clash != inputForOutput.end()) {
+            std::cout << "Both " << clash->second.getFullPathName() << " and " << input.getFullPathName()
+                      << " would be written to " << getOutputFile(input, settings).getFullPathName()
+                      << "; rename one or render them separately" << std::endl;
+            return 1;
+        }
+        inputForOutput.emplace(key, input);
+    }
+
+    RenderTotals totals;
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+    {
+        juce::ThreadPool pool(numThreads);
+        for (const auto& input : inputs)
+            pool.addJob(new RenderJob(input, getOutputFile(input, settings), settings, formatManager, totals), true);
+
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep(20);
+    }
+    const double elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+    // Throughput is reported against the average input sample rate
+    const int rendered = totals.rendered.load();
+    const double averageRate = rendered > 0 ? static_cast<double>(totals.sampleRateSum.load()) / rendered : 0.0;
+    const double audioSeconds = averageRate > 0.0 ? static_cast<double>(totals.samplesRendered.load()) / averageRate : 0.0;
+
+    std::cout << rendered << " rendered, " << totals.failed.load() << " failed, "
+              << juce::String(audioSeconds, 1) << "s of audio in " << juce::String(elapsedSeconds, 2) << "s ("
+              << juce::String(elapsedSeconds > 0.0 ? audioSeconds / elapsedSeconds : 0.0, 1) << "x realtime)" << std::endl;
+
+    return totals.failed.load() == 0 ? 0 : 1;
+}
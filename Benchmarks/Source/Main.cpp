@@ -0,0 +1,445 @@
+#include <JuceHeader.h>
+#include <iostream>
+#include "../../Source/PluginProcessor.h"
+
+// Microbenchmarks for the panner's hot paths. Results go out as JSON so runs can be
+// diffed against a stored baseline.
+//
+// Usage: Benchmarks [--out=results.json] [--min-time=0.05] [--quick]
+
+namespace {
+    struct BenchmarkSettings {
+        double minSeconds = 0.05;
+        bool quick = false;
+    };
+
+    class BenchmarkRunner {
+    public:
+        explicit BenchmarkRunner(const BenchmarkSettings& s) : settings(s) {}
+
+        // Runs 'body' in doubling batches until a batch takes at least minSeconds.
+        // itemsPerIteration turns the timing into a throughput (samples, points, bytes...).
+        template <typename Body>
+        void run(const juce::String& name, juce::DynamicObject::Ptr parameters, double itemsPerIteration, Body&& body) {
+            body(); // warm-up
+
+            juce::int64 iterations = 1;
+            double seconds = 0.0;
+            for (;;) {
+                const auto start = juce::Time::getHighResolutionTicks();
+                for (juce::int64 i = 0; i < iterations; ++i)
+                    body();
+                seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+                if (seconds >= settings.minSeconds || iterations >= (juce::int64(1) << 40)) break;
+                iterations *= 2;
+            }
+
+            const double nsPerIteration = seconds * 1.0e9 / static_cast<double>(iterations);
+            juce::DynamicObject::Ptr result = new juce::DynamicObject();
+            result->setProperty("name", name);
+            result->setProperty("parameters", juce::var(parameters.get()));
+            result->setProperty("iterations", iterations);
+            result->setProperty("ns_per_iteration", nsPerIteration);
+            result->setProperty("items_per_second", itemsPerIteration * 1.0e9 / nsPerIteration);
+            results.add(juce::var(result.get()));
+
+            std::cerr << name << " " << juce::JSON::toString(juce::var(parameters.get()), true)
+                      << ": " << juce::String(nsPerIteration, 1) << " ns" << std::endl;
+        }
+
+        juce::var getResults() const { return results; }
+
+    private:
+        const BenchmarkSettings& settings;
+        juce::Array<juce::var> results;
+    };
+
+    juce::DynamicObject::Ptr makeParameters(std::initializer_list<std::pair<const char*, juce::var>> values) {
+        juce::DynamicObject::Ptr object = new juce::DynamicObject();
+        for (const auto& value : values)
+            object->setProperty(value.first, value.second);
+        return object;
+    }
+
+    // Evenly spaced points over 'duration' following a slow sine, as generated by the editor
+    juce::String makeCurveText(int numPoints, double duration) {
+        juce::MemoryOutputStream text;
+        for (int i = 0; i < numPoints; ++i) {
+            const double t = duration * i / juce::jmax(1, numPoints - 1);
+            text << juce::String(t, 6) << " " << juce::String(std::sin(t * 0.7), 4) << "\n";
+        }
+        return text.toString();
+    }
+
+    // A playing transport that loops over the 60 s benchmark curves. It moves on one block per
+    // query, and processBlock asks once per block. Without it the free-running time would carry
+    // long runs past the last point, where the curve just holds and costs next to nothing.
+    class LoopingPlayHead : public juce::AudioPlayHead {
+    public:
+        explicit LoopingPlayHead(double loopSeconds = 60.0) : loopLength(loopSeconds) {}
+
+        void prepare(double newSampleRate, int newBlockSize) {
+            sampleRate = newSampleRate;
+            blockSize = newBlockSize;
+            position = 0;
+        }
+
+        juce::Optional<PositionInfo> getPosition() const override {
+            PositionInfo info;
+            info.setIsPlaying(true);
+            info.setTimeInSamples(position);
+            info.setTimeInSeconds(static_cast<double>(position) / sampleRate);
+            position += blockSize;
+            if (static_cast<double>(position) >= loopLength * sampleRate) position = 0;
+            return info;
+        }
+
+    private:
+        double loopLength;
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        mutable juce::int64 position = 0;
+    };
+
+    void configure(PanningProcessor& processor, LoopingPlayHead& playHead, int numInputs, double sampleRate, int blockSize,
+                   bool constantPower, bool useCurve) {
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(numInputs == 1 ? juce::AudioChannelSet::mono()
+                            : numInputs == 2 ? juce::AudioChannelSet::stereo()
+                                             : juce::AudioChannelSet::discreteChannels(numInputs));
+        layout.inputBuses.add(juce::AudioChannelSet::disabled());
+        layout.outputBuses.add(juce::AudioChannelSet::stereo());
+        processor.setBusesLayout(layout);
+
+        processor.params.getParameter("law")->setValueNotifyingHost(constantPower ? 1.0f : 0.0f);
+        processor.params.getParameter("sync")->setValueNotifyingHost(useCurve ? 1.0f : 0.0f);
+        processor.params.getParameter("pan")->setValueNotifyingHost(0.3f);
+        processor.setNonRealtime(false);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        playHead.prepare(sampleRate, blockSize);
+        processor.setPlayHead(&playHead);
+    }
+
+    void fillNoise(juce::AudioBuffer<float>& buffer) {
+        juce::Random random(1234);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+    }
+
+    void benchmarkProcessBlock(BenchmarkRunner& runner, const BenchmarkSettings& settings) {
+        const std::vector<int> blockSizes = settings.quick ? std::vector<int>{ 64, 512 }
+                                                           : std::vector<int>{ 32, 64, 128, 256, 512, 1024, 4096 };
+        const std::vector<double> sampleRates = settings.quick ? std::vector<double>{ 48000.0 }
+                                                               : std::vector<double>{ 44100.0, 48000.0, 96000.0, 192000.0 };
+        const auto curveText = makeCurveText(1000, 60.0);
+
+        for (int numInputs : { 1, 2 }) {
+            for (bool constantPower : { false, true }) {
+                for (bool useCurve : { false, true }) {
+                    for (double sampleRate : sampleRates) {
+                        for (int blockSize : blockSizes) {
+                            LoopingPlayHead playHead; // outlives the processor
+                            PanningProcessor processor;
+                            processor.setBreakpointText(curveText);
+                            configure(processor, playHead, numInputs, sampleRate, blockSize, constantPower, useCurve);
+
+                            juce::AudioBuffer<float> buffer(2, blockSize);
+                            juce::MidiBuffer midi;
+                            fillNoise(buffer);
+
+                            runner.run("processBlock",
+                                makeParameters({ { "inputs", numInputs }, { "law", constantPower ? "power" : "linear" },
+                                                 { "source", useCurve ? "breakpoints" : "parameter" },
+                                                 { "sample_rate", sampleRate }, { "block_size", blockSize } }),
+                                blockSize, [&] { processor.processBlock(buffer, midi); });
+                        }
+                    }
+                }
+            }
+        }
+
+        // Curve density at a typical host setting
+        for (int numPoints : { 2, 1000, 100000, 1000000 }) {
+            LoopingPlayHead playHead;
+            PanningProcessor processor;
+            processor.setBreakpointText(makeCurveText(numPoints, 60.0));
+            configure(processor, playHead, 2, 48000.0, 512, true, true);
+
+            juce::AudioBuffer<float> buffer(2, 512);
+            juce::MidiBuffer midi;
+            fillNoise(buffer);
+
+            runner.run("processBlock_density",
+                makeParameters({ { "points", numPoints }, { "sample_rate", 48000.0 }, { "block_size", 512 } }),
+                512, [&] { processor.processBlock(buffer, midi); });
+        }
+    }
+
+    // Object-bus mode: one instance mixing many mono sources, each with its own lane.
+    // Items are source-samples, so the rate compares directly with a single mono instance.
+    void benchmarkObjects(BenchmarkRunner& runner) {
+        for (int numSources : { 8, 32, 128 }) {
+            juce::MemoryOutputStream text;
+            text << "# columns: time";
+            for (int source = 1; source <= numSources; ++source)
+                text << " obj" << source;
+            text << "\n";
+            for (int row = 0; row <= 600; ++row) {
+                text << juce::String(row * 0.1, 3);
+                for (int source = 0; source < numSources; ++source)
+                    text << " " << juce::String(std::sin(row * 0.07 + source), 4);
+                text << "\n";
+            }
+
+            for (bool constantPower : { false, true }) {
+                LoopingPlayHead playHead;
+                PanningProcessor processor;
+                processor.setBreakpointText(text.toString());
+                configure(processor, playHead, numSources, 48000.0, 512, constantPower, true);
+
+                juce::AudioBuffer<float> buffer(numSources, 512);
+                juce::MidiBuffer midi;
+                fillNoise(buffer);
+
+                runner.run("processBlock_objects",
+                    makeParameters({ { "sources", numSources }, { "law", constantPower ? "power" : "linear" },
+                                     { "sample_rate", 48000.0 }, { "block_size", 512 } }),
+                    512.0 * numSources, [&] { processor.processBlock(buffer, midi); });
+            }
+        }
+    }
+
+    // Sidechain modulation on top of the breakpoint curve
+    void benchmarkSidechain(BenchmarkRunner& runner) {
+        for (int mode : { 1, 2 }) {
+            LoopingPlayHead playHead;
+            PanningProcessor processor;
+            processor.setBreakpointText(makeCurveText(1000, 60.0));
+            configure(processor, playHead, 2, 48000.0, 512, true, true);
+
+            juce::AudioProcessor::BusesLayout layout = processor.getBusesLayout();
+            layout.inputBuses.set(1, juce::AudioChannelSet::stereo());
+            processor.setBusesLayout(layout);
+            processor.params.getParameter("scmode")->setValueNotifyingHost(processor.params.getParameter("scmode")->convertTo0to1((float)mode));
+            processor.prepareToPlay(48000.0, 512);
+
+            juce::AudioBuffer<float> buffer(4, 512);
+            juce::MidiBuffer midi;
+            fillNoise(buffer);
+
+            runner.run("processBlock_sidechain",
+                makeParameters({ { "mode", mode == 1 ? "level" : "correlation" }, { "sample_rate", 48000.0 }, { "block_size", 512 } }),
+                512, [&] { processor.processBlock(buffer, midi); });
+        }
+    }
+
+    // Dense controller input splits every block into many short segments
+    void benchmarkMidi(BenchmarkRunner& runner) {
+        for (int eventInterval : { 512, 64, 8 }) {
+            LoopingPlayHead playHead;
+            PanningProcessor processor;
+            configure(processor, playHead, 2, 48000.0, 512, true, false);
+            processor.params.getParameter("midimode")->setValueNotifyingHost(processor.params.getParameter("midimode")->convertTo0to1(1.0f));
+
+            juce::AudioBuffer<float> buffer(2, 512);
+            juce::MidiBuffer midi;
+            for (int i = 0; i < 512; i += eventInterval)
+                midi.addEvent(juce::MidiMessage::controllerEvent(1, 10, (i / eventInterval * 17) % 128), i);
+            fillNoise(buffer);
+
+            runner.run("processBlock_midi",
+                makeParameters({ { "event_interval", eventInterval }, { "sample_rate", 48000.0 }, { "block_size", 512 } }),
+                512, [&] { processor.processBlock(buffer, midi); });
+        }
+    }
+
+    void benchmarkPanLaws(BenchmarkRunner& runner) {
+        PanningProcessor processor;
+        constexpr int numPositions = 4096;
+        std::vector<float> positions(numPositions);
+        for (int i = 0; i < numPositions; ++i)
+            positions[(size_t)i] = -1.0f + 2.0f * static_cast<float>(i) / (numPositions - 1);
+
+        float sink = 0.0f;
+        runner.run("linearPan", makeParameters({ { "positions", numPositions } }), numPositions, [&] {
+            for (float position : positions) {
+                auto gains = processor.linearPan(position);
+                sink += gains.left + gains.right;
+            }
+        });
+        runner.run("constantPowerPan", makeParameters({ { "positions", numPositions } }), numPositions, [&] {
+            for (float position : positions) {
+                auto gains = processor.constantPowerPan(position);
+                sink += gains.left + gains.right;
+            }
+        });
+        juce::ignoreUnused(sink);
+    }
+
+    void benchmarkBreakpointLookup(BenchmarkRunner& runner) {
+        constexpr double duration = 60.0;
+        constexpr int numLookups = 4096;
+
+        for (int numPoints : { 2, 1000, 100000, 1000000 }) {
+            PanningProcessor processor;
+            processor.setBreakpointText(makeCurveText(numPoints, duration));
+
+            // Sequential: consecutive samples at 48kHz, wrapping at the end of the curve
+            double time = 0.0;
+            float sink = 0.0f;
+            runner.run("getBreakpointValue_sequential", makeParameters({ { "points", numPoints } }), numLookups, [&] {
+                for (int i = 0; i < numLookups; ++i) {
+                    sink += processor.getBreakpointValue(time);
+                    time += 1.0 / 48000.0;
+                }
+                if (time > duration) time = 0.0;
+            });
+
+            juce::Random random(42);
+            std::vector<double> times(numLookups);
+            for (auto& t : times)
+                t = random.nextDouble() * duration;
+
+            runner.run("getBreakpointValue_random", makeParameters({ { "points", numPoints } }), numLookups, [&] {
+                for (double t : times)
+                    sink += processor.getBreakpointValue(t);
+            });
+
+            // The same sequential walk through the sample-indexed form processBlock uses
+            const auto prepared = PreparedCurve::fromTable(processor.parseBreakpointText(makeCurveText(numPoints, duration)).pan, 48000.0);
+            std::vector<float> output(numLookups);
+            juce::int64 position = 0;
+            PreparedCurve::Cursor cursor;
+            runner.run("PreparedCurve_render", makeParameters({ { "points", numPoints } }), numLookups, [&] {
+                prepared.render(position, numLookups, cursor, output.data());
+                position += numLookups;
+                if (position > static_cast<juce::int64>(duration * 48000.0)) position = 0;
+                sink += output[0];
+            });
+            juce::ignoreUnused(sink);
+        }
+    }
+
+    // An expression against tables sampling the same shape (makeCurveText follows sin(0.7 t))
+    void benchmarkExpression(BenchmarkRunner& runner) {
+        const juce::String expressionText = "pan = sin(0.7*t)\n";
+        const std::vector<std::pair<juce::String, juce::String>> sources {
+            { "expression", expressionText },
+            { "table_1k", makeCurveText(1000, 60.0) },
+            { "table_1m", makeCurveText(1000000, 60.0) }
+        };
+
+        for (const auto& source : sources) {
+            LoopingPlayHead playHead;
+            PanningProcessor processor;
+            processor.setBreakpointText(source.second);
+            configure(processor, playHead, 2, 48000.0, 512, true, true);
+
+            juce::AudioBuffer<float> buffer(2, 512);
+            juce::MidiBuffer midi;
+            fillNoise(buffer);
+
+            runner.run("processBlock_curveSource",
+                makeParameters({ { "source", source.first }, { "sample_rate", 48000.0 }, { "block_size", 512 } }),
+                512, [&] { processor.processBlock(buffer, midi); });
+        }
+
+        for (const char* text : { "sin(0.7*t)", "0.8*sin(2*pi*0.25*t) + noise(t, 3)", "clamp(tri(t*0.5) * 1.5, -1, 1)" }) {
+            juce::String error;
+            auto expression = CurveExpression::compile(text, error);
+            std::vector<double> workspace(CurveExpression::workspaceSize);
+            std::vector<float> output(512);
+            double time = 0.0;
+
+            runner.run("CurveExpression_evaluate", makeParameters({ { "expression", text }, { "block_size", 512 } }), 512, [&] {
+                expression->evaluate(time, 1.0 / 48000.0, 512, output.data(), workspace.data());
+                time += 512.0 / 48000.0;
+            });
+        }
+    }
+
+    void benchmarkNoise(BenchmarkRunner& runner) {
+        constexpr int numValues = 1 << 20;
+        std::vector<float> values(numValues);
+        const std::pair<const char*, NoiseGenerator::Shape> shapes[] = {
+            { "white", NoiseGenerator::Shape::white }, { "value", NoiseGenerator::Shape::value },
+            { "gradient", NoiseGenerator::Shape::gradient }
+        };
+
+        for (const auto& shape : shapes) {
+            runner.run("NoiseGenerator_generate", makeParameters({ { "shape", shape.first }, { "values", numValues } }), numValues, [&] {
+                NoiseGenerator::generate(shape.second, 1234, 0.0, 0.125, values.data(), numValues);
+            });
+        }
+    }
+
+    void benchmarkText(BenchmarkRunner& runner) {
+        for (int numPoints : { 1000, 100000, 1000000 }) {
+            PanningProcessor processor;
+            const auto text = makeCurveText(numPoints, 60.0);
+            const auto numBytes = static_cast<double>(text.getNumBytesAsUTF8());
+
+            runner.run("parseBreakpointText", makeParameters({ { "points", numPoints }, { "bytes", numBytes } }), numBytes, [&] {
+                auto table = processor.parseBreakpointText(text);
+                juce::ignoreUnused(table);
+            });
+
+            processor.setBreakpointText(text);
+            runner.run("getBreakpointText", makeParameters({ { "points", numPoints } }), numPoints, [&] {
+                auto serialised = processor.getBreakpointText();
+                juce::ignoreUnused(serialised);
+            });
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    BenchmarkSettings settings;
+    settings.quick = args.containsOption("--quick");
+    if (args.containsOption("--min-time"))
+        settings.minSeconds = juce::jmax(0.001, args.getValueForOption("--min-time").getDoubleValue());
+
+    BenchmarkRunner runner(settings);
+    benchmarkProcessBlock(runner, settings);
+    benchmarkObjects(runner);
+    benchmarkSidechain(runner);
+    benchmarkMidi(runner);
+    benchmarkPanLaws(runner);
+    benchmarkBreakpointLookup(runner);
+    benchmarkExpression(runner);
+    benchmarkNoise(runner);
+    benchmarkText(runner);
+
+    juce::DynamicObject::Ptr context = new juce::DynamicObject();
+    context->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+    context->setProperty("cpu", juce::SystemStats::getCpuModel());
+    context->setProperty("num_cpus", juce::SystemStats::getNumCpus());
+    context->setProperty("os", juce::SystemStats::getOperatingSystemName());
+   #if JUCE_DEBUG
+    context->setProperty("build", "debug");
+   #else
+    context->setProperty("build", "release");
+   #endif
+
+    juce::DynamicObject::Ptr report = new juce::DynamicObject();
+    report->setProperty("context", juce::var(context.get()));
+    report->setProperty("benchmarks", runner.getResults());
+    const auto json = juce::JSON::toString(juce::var(report.get()));
+
+    if (args.containsOption("--out")) {
+        auto outputFile = args.getFileForOption("--out");
+        if (!outputFile.replaceWithText(json)) {
+            std::cerr << "Can't write " << outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else {
+        std::cout << json << std::endl;
+    }
+    return 0;
+}
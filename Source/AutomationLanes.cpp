@@ -0,0 +1,78 @@
+#include "AutomationLanes.h"
+
+const char* AutomationLanes::getLaneName(int lane) {
+    switch (lane) {
+    case gainLane:  return "gain";
+    case widthLane: return "width";
+    case lawLane:   return "law";
+    default:        return "";
+    }
+}
+
+float AutomationLanes::getDefaultValue(int lane) {
+    juce::ignoreUnused(lane);
+    return 1.0f; // unity gain, unchanged width, constant power
+}
+
+juce::Range<float> AutomationLanes::getValueRange(int lane) {
+    switch (lane) {
+    case gainLane:  return { 0.0f, 4.0f };  // linear gain, up to +12 dB
+    case widthLane: return { 0.0f, 2.0f };  // 0 = mono, 1 = unchanged, 2 = double side level
+    case lawLane:   return { 0.0f, 1.0f };  // 0 = linear, 1 = constant power
+    default:        return { 0.0f, 1.0f };
+    }
+}
+
+void AutomationLanes::addRow(double time, const float* laneValues) {
+    jassert(times.empty() || time >= times.back());
+    times.push_back(time);
+
+    for (int lane = 0; lane < numLanes; ++lane) {
+        auto& column = values[(size_t)lane];
+        float value = laneValues[lane];
+        if (std::isnan(value))
+            value = column.empty() ? getDefaultValue(lane) : column.back();
+        column.push_back(getValueRange(lane).clipValue(value));
+    }
+}
+
+void AutomationLanes::render(double startTime, double increment, int numSamples, size_t& cursor, float* const* outputs) const {
+    const size_t numRows = times.size();
+    if (numRows == 0) return;
+
+    int activeLanes[numLanes];
+    int numActive = 0;
+    for (int lane = 0; lane < numLanes; ++lane) {
+        if (present[(size_t)lane] && outputs[lane] != nullptr)
+            activeLanes[numActive++] = lane;
+    }
+
+    cursor = juce::jmin(cursor, numRows - 1);
+    double time = startTime;
+
+    for (int i = 0; i < numSamples; ++i) {
+        // Seeks binary-search; normal playback advances one cursor for all lanes
+        if ((cursor > 0 && time < times[cursor]) || (cursor + 2 < numRows && time > times[cursor + 2])) {
+            auto it = std::lower_bound(times.begin(), times.end(), time);
+            auto index = static_cast<size_t>(it - times.begin());
+            cursor = index > 0 ? index - 1 : 0;
+        }
+        while (cursor + 1 < numRows && time > times[cursor + 1]) ++cursor;
+
+        if (cursor + 1 >= numRows || time <= times[cursor]) {
+            // Before the first row or after the last one the nearest value is held
+            const size_t row = time <= times[cursor] ? cursor : numRows - 1;
+            for (int a = 0; a < numActive; ++a)
+                outputs[activeLanes[a]][i] = values[(size_t)activeLanes[a]][row];
+        }
+        else {
+            const double span = times[cursor + 1] - times[cursor];
+            const float fraction = span > 0.0 ? static_cast<float>((time - times[cursor]) / span) : 1.0f;
+            for (int a = 0; a < numActive; ++a) {
+                const auto& column = values[(size_t)activeLanes[a]];
+                outputs[activeLanes[a]][i] = column[cursor] + (column[cursor + 1] - column[cursor]) * fraction;
+            }
+        }
+        time += increment;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <JuceHeader.h>
+
+// The extra columns of a multi-lane breakpoint file (output gain, stereo width and pan-law
+// crossfade), stored as one shared time column plus one value array per lane, so a single
+// cursor advance per sample serves every lane. Built once when a file is parsed, then immutable.
+class AutomationLanes {
+public:
+    enum Lane { gainLane, widthLane, lawLane, numLanes };
+
+    static const char* getLaneName(int lane);
+    static float getDefaultValue(int lane);
+    static juce::Range<float> getValueRange(int lane);
+
+    // Rows must be added in time order; missing lanes (NaN) repeat their previous value
+    void addRow(double time, const float* laneValues);
+    void setLanePresent(int lane) { present[(size_t)lane] = true; }
+
+    bool isEmpty() const noexcept { return times.empty(); }
+    bool hasLane(int lane) const noexcept { return present[(size_t)lane]; }
+    size_t size() const noexcept { return times.size(); }
+    double getTime(size_t row) const { return times[row]; }
+    float getValue(int lane, size_t row) const { return values[(size_t)lane][row]; }
+
+    // Audio thread: writes each present lane's value at startTime + i * increment into outputs[lane].
+    // 'cursor' is the caller's position in the time column and persists between blocks.
+    void render(double startTime, double increment, int numSamples, size_t& cursor, float* const* outputs) const;
+
+private:
+    std::vector<double> times;
+    std::array<std::vector<float>, numLanes> values;
+    std::array<bool, numLanes> present{};
+};
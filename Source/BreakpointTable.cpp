@@ -0,0 +1,213 @@
+#include "BreakpointTable.h"
+
+BreakpointTable BreakpointTable::fromSorted(const std::vector<Breakpoint>& points) {
+    BreakpointTable table;
+    for (size_t start = 0; start < points.size(); start += chunkCapacity) {
+        auto end = juce::jmin(points.size(), start + chunkCapacity);
+        table.chunks.push_back(std::make_shared<Chunk>(points.begin() + (std::ptrdiff_t)start,
+                                                       points.begin() + (std::ptrdiff_t)end));
+    }
+    table.rebuildChunkEnds();
+    return table;
+}
+
+size_t BreakpointTable::findChunk(size_t index) const {
+    auto it = std::upper_bound(chunkEnds.begin(), chunkEnds.end(), index);
+    return static_cast<size_t>(it - chunkEnds.begin());
+}
+
+const Breakpoint& BreakpointTable::operator[](size_t index) const {
+    jassert(index < totalSize);
+    auto chunkIndex = findChunk(index);
+    return (*chunks[chunkIndex])[index - chunkStart(chunkIndex)];
+}
+
+std::vector<Breakpoint> BreakpointTable::toVector() const {
+    std::vector<Breakpoint> result;
+    result.reserve(totalSize);
+    for (const auto& chunk : chunks)
+        result.insert(result.end(), chunk->begin(), chunk->end());
+    return result;
+}
+
+std::vector<Breakpoint> BreakpointTable::toVector(size_t first, size_t last) const {
+    last = juce::jmin(last, totalSize);
+    std::vector<Breakpoint> result;
+    if (first >= last) return result;
+
+    result.reserve(last - first);
+    for (auto chunkIndex = findChunk(first); chunkIndex < chunks.size() && chunkStart(chunkIndex) < last; ++chunkIndex) {
+        const auto& chunk = *chunks[chunkIndex];
+        const auto start = chunkStart(chunkIndex);
+        result.insert(result.end(), chunk.begin() + (std::ptrdiff_t)(juce::jmax(first, start) - start),
+                      chunk.begin() + (std::ptrdiff_t)(juce::jmin(last, chunkEnds[chunkIndex]) - start));
+    }
+    return result;
+}
+
+size_t BreakpointTable::countChunksSharedWith(const BreakpointTable& other) const {
+    std::unordered_set<const Chunk*> otherChunks;
+    for (const auto& chunk : other.chunks)
+        otherChunks.insert(chunk.get());
+    return static_cast<size_t>(std::count_if(chunks.begin(), chunks.end(),
+        [&otherChunks](const auto& chunk) { return otherChunks.count(chunk.get()) > 0; }));
+}
+
+template <typename Compare>
+size_t BreakpointTable::searchByTime(double time, Compare isBefore) const {
+    // Find the first chunk whose last point passes the test, then search inside it
+    auto chunkIt = std::upper_bound(chunks.begin(), chunks.end(), time,
+        [&isBefore](double t, const std::shared_ptr<const Chunk>& chunk) { return isBefore(t, chunk->back().time); });
+    if (chunkIt == chunks.end()) return totalSize;
+
+    auto chunkIndex = static_cast<size_t>(chunkIt - chunks.begin());
+    const auto& chunk = **chunkIt;
+    auto pointIt = std::upper_bound(chunk.begin(), chunk.end(), time,
+        [&isBefore](double t, const Breakpoint& point) { return isBefore(t, point.time); });
+    return chunkStart(chunkIndex) + static_cast<size_t>(pointIt - chunk.begin());
+}
+
+size_t BreakpointTable::upperBound(double time) const {
+    return searchByTime(time, [](double t, double pointTime) { return t < pointTime; });
+}
+
+size_t BreakpointTable::lowerBound(double time) const {
+    return searchByTime(time, [](double t, double pointTime) { return t <= pointTime; });
+}
+
+BreakpointTable BreakpointTable::withInsertedAt(size_t index, Breakpoint point) const {
+    jassert(index <= totalSize);
+    BreakpointTable result(*this);
+
+    if (result.chunks.empty()) {
+        result.chunks.push_back(std::make_shared<Chunk>(1, point));
+        result.rebuildChunkEnds();
+        return result;
+    }
+
+    // Appending goes into the last chunk rather than opening a new one
+    auto chunkIndex = juce::jmin(findChunk(index), chunks.size() - 1);
+    auto offset = index - chunkStart(chunkIndex);
+
+    Chunk edited(*chunks[chunkIndex]);
+    edited.insert(edited.begin() + (std::ptrdiff_t)offset, point);
+
+    if (edited.size() > 2 * chunkCapacity) {
+        auto middle = edited.begin() + (std::ptrdiff_t)(edited.size() / 2);
+        result.chunks[chunkIndex] = std::make_shared<Chunk>(edited.begin(), middle);
+        result.chunks.insert(result.chunks.begin() + (std::ptrdiff_t)chunkIndex + 1,
+                             std::make_shared<Chunk>(middle, edited.end()));
+        result.rebuildChunkEnds();
+    }
+    else {
+        result.chunks[chunkIndex] = std::make_shared<Chunk>(std::move(edited));
+        for (auto i = chunkIndex; i < result.chunkEnds.size(); ++i)
+            ++result.chunkEnds[i];
+        ++result.totalSize;
+    }
+    return result;
+}
+
+BreakpointTable BreakpointTable::withInserted(Breakpoint point, size_t* insertedIndex) const {
+    auto index = upperBound(point.time);
+    if (insertedIndex != nullptr) *insertedIndex = index;
+    return withInsertedAt(index, point);
+}
+
+BreakpointTable BreakpointTable::withRemoved(size_t index) const {
+    jassert(index < totalSize);
+    BreakpointTable result(*this);
+    auto chunkIndex = findChunk(index);
+    auto offset = index - chunkStart(chunkIndex);
+
+    if (chunks[chunkIndex]->size() == 1) {
+        result.chunks.erase(result.chunks.begin() + (std::ptrdiff_t)chunkIndex);
+        result.rebuildChunkEnds();
+        return result;
+    }
+
+    Chunk edited(*chunks[chunkIndex]);
+    edited.erase(edited.begin() + (std::ptrdiff_t)offset);
+    result.chunks[chunkIndex] = std::make_shared<Chunk>(std::move(edited));
+    for (auto i = chunkIndex; i < result.chunkEnds.size(); ++i)
+        --result.chunkEnds[i];
+    --result.totalSize;
+    return result;
+}
+
+BreakpointTable BreakpointTable::withMoved(size_t index, Breakpoint point, size_t* newIndex) const {
+    return withRemoved(index).withInserted(point, newIndex);
+}
+
+BreakpointTable BreakpointTable::withReplaced(size_t first, size_t last, const std::vector<Breakpoint>& points) const {
+    last = juce::jmin(last, totalSize);
+    if (first > last || (first == last && points.empty())) return *this;
+    if (chunks.empty()) return fromSorted(points);
+
+    // The chunks holding the range (or the insertion point), widened while the new points' times
+    // cross into a neighbour
+    size_t firstChunk = findChunk(juce::jmin(first, totalSize - 1));
+    size_t lastChunk = first < last ? findChunk(last - 1) : firstChunk;
+    if (!points.empty()) {
+        while (firstChunk > 0 && chunks[firstChunk - 1]->back().time > points.front().time) --firstChunk;
+        while (lastChunk + 1 < chunks.size() && chunks[lastChunk + 1]->front().time < points.back().time) ++lastChunk;
+    }
+
+    // Same order as sorting the whole curve with the replaced points in place: stable, so points
+    // with equal times keep their sides
+    const auto regionStart = chunkStart(firstChunk);
+    const auto regionEnd = chunkEnds[lastChunk];
+    std::vector<Breakpoint> region;
+    region.reserve(regionEnd - regionStart - (last - first) + points.size());
+    auto before = toVector(regionStart, first);
+    auto after = toVector(last, regionEnd);
+    region.insert(region.end(), before.begin(), before.end());
+    region.insert(region.end(), points.begin(), points.end());
+    region.insert(region.end(), after.begin(), after.end());
+    std::stable_sort(region.begin(), region.end(),
+        [](const Breakpoint& a, const Breakpoint& b) { return a.time < b.time; });
+
+    std::vector<std::shared_ptr<const Chunk>> rebuilt;
+    for (size_t start = 0; start < region.size(); start += chunkCapacity) {
+        auto end = juce::jmin(region.size(), start + chunkCapacity);
+        rebuilt.push_back(std::make_shared<Chunk>(region.begin() + (std::ptrdiff_t)start, region.begin() + (std::ptrdiff_t)end));
+    }
+
+    BreakpointTable result(*this);
+    result.chunks.erase(result.chunks.begin() + (std::ptrdiff_t)firstChunk, result.chunks.begin() + (std::ptrdiff_t)lastChunk + 1);
+    result.chunks.insert(result.chunks.begin() + (std::ptrdiff_t)firstChunk, rebuilt.begin(), rebuilt.end());
+    result.rebuildChunkEnds();
+    return result;
+}
+
+void BreakpointTable::rebuildChunkEnds() {
+    chunkEnds.resize(chunks.size());
+    size_t count = 0;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        count += chunks[i]->size();
+        chunkEnds[i] = count;
+    }
+    totalSize = count;
+}
+
+double BreakpointTable::getValueAt(double time, size_t& cursor, bool* searched) const {
+    jassert(!empty());
+    cursor = juce::jmin(cursor, totalSize - 1);
+
+    if ((cursor > 0 && time < (*this)[cursor].time)
+        || (cursor + 2 < totalSize && time > (*this)[cursor + 2].time)) {
+        auto index = lowerBound(time);
+        cursor = index > 0 ? index - 1 : 0;
+        if (searched != nullptr) *searched = true;
+    }
+    while (cursor + 1 < totalSize && time > (*this)[cursor + 1].time) {
+        ++cursor;
+    }
+    if (cursor >= totalSize - 1) return back().value;
+    const auto& left = (*this)[cursor];
+    if (cursor == 0 && time <= left.time) return left.value;
+    const auto& right = (*this)[cursor + 1];
+    if (right.time - left.time == 0.0) return right.value;
+    double fraction = (time - left.time) / (right.time - left.time);
+    return left.value + (right.value - left.value) * fraction;
+}
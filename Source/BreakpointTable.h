@@ -0,0 +1,66 @@
+#pragma once
+#include <JuceHeader.h>
+
+struct Breakpoint { double time; double value; };
+
+// Persistent, time-ordered breakpoint storage. Points live in immutable chunks that
+// copies share, so every edit only copies the chunk it touches plus the chunk index.
+// That keeps undo snapshots of very large curves cheap: a snapshot is just a table.
+class BreakpointTable {
+public:
+    static constexpr size_t chunkCapacity = 1024;
+    using Chunk = std::vector<Breakpoint>;
+
+    BreakpointTable() = default;
+    static BreakpointTable fromSorted(const std::vector<Breakpoint>& points);
+
+    size_t size() const noexcept { return totalSize; }
+    bool empty() const noexcept { return totalSize == 0; }
+    size_t getNumChunks() const noexcept { return chunks.size(); }
+    const std::shared_ptr<const Chunk>& getChunk(size_t chunkIndex) const { return chunks[chunkIndex]; }
+    bool sharesStorageWith(const BreakpointTable& other) const noexcept { return chunks == other.chunks; }
+
+    const Breakpoint& operator[](size_t index) const;
+    const Breakpoint& back() const { return chunks.back()->back(); }
+
+    std::vector<Breakpoint> toVector() const;
+    std::vector<Breakpoint> toVector(size_t first, size_t last) const; // points [first, last)
+    size_t countChunksSharedWith(const BreakpointTable& other) const;
+
+    template <typename Callback>
+    void forEach(Callback&& callback) const {
+        for (const auto& chunk : chunks)
+            for (const auto& point : *chunk)
+                callback(point);
+    }
+
+    // First index with a time later than (upperBound) or not earlier than (lowerBound) 'time'
+    size_t upperBound(double time) const;
+    size_t lowerBound(double time) const;
+
+    // Linear interpolation at 'time', holding the end values. 'cursor' is the caller's position and
+    // persists between calls: playback steps it forward, backward or far jumps binary-search
+    // (reported through 'searched'). Needs at least one point.
+    double getValueAt(double time, size_t& cursor, bool* searched = nullptr) const;
+
+    BreakpointTable withInserted(Breakpoint point, size_t* insertedIndex = nullptr) const;
+    BreakpointTable withRemoved(size_t index) const;
+    BreakpointTable withMoved(size_t index, Breakpoint point, size_t* newIndex = nullptr) const;
+
+    // Replaces points [first, last) with 'points' (in time order); an empty range inserts them.
+    // Only the chunks holding the range are rebuilt, plus any neighbours the new points' times
+    // reach into; the rest are shared.
+    BreakpointTable withReplaced(size_t first, size_t last, const std::vector<Breakpoint>& points) const;
+
+private:
+    std::vector<std::shared_ptr<const Chunk>> chunks;
+    std::vector<size_t> chunkEnds; // cumulative point count at the end of each chunk
+    size_t totalSize = 0;
+
+    size_t findChunk(size_t index) const;
+    template <typename Compare>
+    size_t searchByTime(double time, Compare isBefore) const;
+    size_t chunkStart(size_t chunkIndex) const { return chunkIndex == 0 ? 0 : chunkEnds[chunkIndex - 1]; }
+    BreakpointTable withInsertedAt(size_t index, Breakpoint point) const;
+    void rebuildChunkEnds();
+};
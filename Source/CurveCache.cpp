@@ -0,0 +1,44 @@
+#include "CurveCache.h"
+
+CurveData CurveCache::getOrParse(const juce::String& key, const std::function<CurveData()>& parse) {
+    {
+        const juce::ScopedLock sl(lock);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            if (auto entry = it->second.lock())
+                return fromEntry(entry);
+        }
+    }
+
+    // Parsing a large file takes a while, so other instances aren't held up meanwhile
+    auto parsed = std::make_shared<const CurveData>(parse());
+
+    const juce::ScopedLock sl(lock);
+    auto& slot = entries[key];
+    if (auto existing = slot.lock())
+        return fromEntry(existing); // another instance got there first; share its copy
+    slot = parsed;
+
+    for (auto it = entries.begin(); it != entries.end();)
+        it = it->second.expired() ? entries.erase(it) : std::next(it);
+
+    return fromEntry(parsed);
+}
+
+CurveData CurveCache::fromEntry(const Entry& entry) {
+    CurveData curve = *entry;
+    curve.cacheEntry = entry;
+    return curve;
+}
+
+juce::String CurveCache::keyForText(const juce::String& text) {
+    // A hit must mean the same text, so the key is the SHA-256 of its UTF-8 bytes rather than a
+    // quick hash that two different texts could share. The text itself isn't kept, so large
+    // files aren't stored twice.
+    return "text:" + juce::SHA256(text.toUTF8()).toHexString();
+}
+
+juce::String CurveCache::keyForFile(const juce::File& file) {
+    return "file:" + file.getFullPathName() + ":" + juce::String(file.getSize())
+         + ":" + juce::String(file.getLastModificationTime().toMilliseconds());
+}
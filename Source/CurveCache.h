@@ -0,0 +1,28 @@
+#pragma once
+#include <JuceHeader.h>
+#include "CurveData.h"
+
+// Parsed curves shared by every PanningProcessor in the process, so a template that loads the
+// same large file into many instances parses and stores it once. Entries are immutable and
+// weakly held: one lives as long as some instance (or its undo history) still uses it and is
+// freed by whichever message or worker thread drops the last reference, never the audio thread.
+//
+// Hold one through juce::SharedResourcePointer<CurveCache>; it's safe to use from any non-audio thread.
+class CurveCache {
+public:
+    // Returns the live entry for 'key', or calls 'parse' (outside the lock) and shares its result.
+    // The returned data's cacheEntry pins the entry for as long as the data is kept.
+    CurveData getOrParse(const juce::String& key, const std::function<CurveData()>& parse);
+
+    // Keys: the SHA-256 of text, path plus size and modification time for files
+    static juce::String keyForText(const juce::String& text);
+    static juce::String keyForFile(const juce::File& file);
+
+private:
+    using Entry = std::shared_ptr<const CurveData>;
+
+    static CurveData fromEntry(const Entry& entry);
+
+    juce::CriticalSection lock;
+    std::map<juce::String, std::weak_ptr<const CurveData>> entries;
+};
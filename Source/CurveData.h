@@ -0,0 +1,23 @@
+#pragma once
+#include <JuceHeader.h>
+#include "BreakpointTable.h"
+#include "AutomationLanes.h"
+#include "ObjectLanes.h"
+#include "CurveExpression.h"
+#include "PreparedCurve.h"
+
+// Everything a breakpoint file describes: the editable pan curve, any extra lanes, per-source
+// object lanes and any "pan = ..." expression lines. Copies share their storage, so keeping them in the undo history is cheap.
+struct CurveData {
+    // Expression slots: pan first, then one per automation lane. An expression replaces the points for its target.
+    enum { panExpression, laneExpressions, numExpressions = laneExpressions + AutomationLanes::numLanes };
+    using Expressions = std::array<std::shared_ptr<const CurveExpression>, numExpressions>;
+
+    BreakpointTable pan;
+    std::shared_ptr<const AutomationLanes> lanes;
+    std::shared_ptr<const ObjectLanes> objects;
+    Expressions expressions;
+    juce::String errors; // expression lines that failed to compile
+    std::shared_ptr<const void> cacheEntry; // keeps the shared CurveCache entry this came from alive
+    std::shared_ptr<PreparedCurveSet> prepared; // 'pan' prepared for playback, shared by every copy
+};
@@ -0,0 +1,360 @@
+#include "CurveExpression.h"
+#include "NoiseGenerator.h"
+
+namespace {
+    using Op = CurveExpression::Op;
+
+    bool isUnary(Op op) { return op >= Op::negate; }
+
+    juce::uint64 toSeed(double seed) { return static_cast<juce::uint64>(static_cast<juce::int64>(seed)); }
+
+    double applyOp(Op op, double a, double b) {
+        switch (op) {
+        case Op::add:      return a + b;
+        case Op::subtract: return a - b;
+        case Op::multiply: return a * b;
+        case Op::divide:   return b != 0.0 ? a / b : 0.0;
+        case Op::modulo:   return b != 0.0 ? a - b * std::floor(a / b) : 0.0;
+        case Op::power:    return std::pow(a, b);
+        case Op::minimum:  return juce::jmin(a, b);
+        case Op::maximum:  return juce::jmax(a, b);
+        case Op::noise:    return NoiseGenerator::value(a, toSeed(b));
+        case Op::gradientNoise: return NoiseGenerator::gradient(a, toSeed(b));
+        case Op::negate:   return -a;
+        case Op::sin:      return std::sin(a);
+        case Op::cos:      return std::cos(a);
+        case Op::tan:      return std::tan(a);
+        case Op::abs:      return std::abs(a);
+        case Op::sqrt:     return a > 0.0 ? std::sqrt(a) : 0.0;
+        case Op::exp:      return std::exp(a);
+        case Op::log:      return a > 0.0 ? std::log(a) : 0.0;
+        case Op::floor:    return std::floor(a);
+        case Op::frac:     return a - std::floor(a);
+        case Op::sign:     return a > 0.0 ? 1.0 : (a < 0.0 ? -1.0 : 0.0);
+        case Op::tri:      return 4.0 * std::abs(a + 0.75 - std::floor(a + 0.75) - 0.5) - 1.0;
+        case Op::saw:      return 2.0 * (a - std::floor(a + 0.5));
+        case Op::square:   return a - std::floor(a) < 0.5 ? 1.0 : -1.0;
+        }
+        return 0.0;
+    }
+
+    // Runs one instruction over a block. The op is chosen once per block, not per sample.
+    template <typename Fn>
+    void runBlock(const CurveExpression::Instruction& in, double* const* regs, int num, Fn&& fn) {
+        double* dest = regs[in.dest];
+        if (!in.a.isConstant() && !in.b.isConstant()) {
+            const double* a = regs[in.a.reg];
+            const double* b = regs[in.b.reg];
+            for (int i = 0; i < num; ++i) dest[i] = fn(a[i], b[i]);
+        }
+        else if (in.a.isConstant()) {
+            const double a = in.a.constant;
+            const double* b = regs[in.b.reg];
+            for (int i = 0; i < num; ++i) dest[i] = fn(a, b[i]);
+        }
+        else {
+            const double* a = regs[in.a.reg];
+            const double b = in.b.constant;
+            for (int i = 0; i < num; ++i) dest[i] = fn(a[i], b);
+        }
+    }
+
+    template <typename Fn>
+    void runUnaryBlock(const CurveExpression::Instruction& in, double* const* regs, int num, Fn&& fn) {
+        double* dest = regs[in.dest];
+        const double* a = regs[in.a.reg];
+        for (int i = 0; i < num; ++i) dest[i] = fn(a[i]);
+    }
+}
+
+//==============================================================================
+// Recursive-descent parser producing a small tree, folded and then flattened to instructions
+class ExpressionCompiler {
+public:
+    ExpressionCompiler(const juce::String& text) : source(text), position(source.getCharPointer()) {}
+
+    std::unique_ptr<CurveExpression> compile(juce::String& error) {
+        auto root = parseExpression();
+        skipWhitespace();
+        if (errorMessage.isEmpty() && !position.isEmpty())
+            fail("Unexpected '" + juce::String::charToString(*position) + "'");
+        if (errorMessage.isNotEmpty()) {
+            error = errorMessage;
+            return nullptr;
+        }
+
+        auto expression = std::make_unique<CurveExpression>();
+        expression->source = source.trim();
+        registerUsed.assign(CurveExpression::maxRegisters, false);
+        registerUsed[0] = true; // holds t
+        expression->result = generate(*root, expression->instructions);
+        if (errorMessage.isNotEmpty()) {
+            error = errorMessage;
+            return nullptr;
+        }
+        return expression;
+    }
+
+private:
+    struct Node {
+        enum class Kind { constant, time, operation } kind = Kind::constant;
+        double value = 0.0;
+        Op op = Op::add;
+        std::unique_ptr<Node> a, b;
+    };
+
+    juce::String source;
+    juce::String::CharPointerType position;
+    juce::String errorMessage;
+    std::vector<bool> registerUsed;
+
+    void fail(const juce::String& message) {
+        if (errorMessage.isEmpty()) errorMessage = message;
+    }
+
+    void skipWhitespace() { position.incrementToEndOfWhitespace(); }
+
+    bool match(juce::juce_wchar c) {
+        skipWhitespace();
+        if (*position == c) {
+            ++position;
+            return true;
+        }
+        return false;
+    }
+
+    static std::unique_ptr<Node> makeConstant(double value) {
+        auto node = std::make_unique<Node>();
+        node->value = value;
+        return node;
+    }
+
+    // Builds an operation node, folding it straight away when every operand is constant
+    static std::unique_ptr<Node> makeOperation(Op op, std::unique_ptr<Node> a, std::unique_ptr<Node> b = nullptr) {
+        const bool constantA = a->kind == Node::Kind::constant;
+        const bool constantB = b == nullptr || b->kind == Node::Kind::constant;
+        if (constantA && constantB)
+            return makeConstant(applyOp(op, a->value, b != nullptr ? b->value : 0.0));
+
+        auto node = std::make_unique<Node>();
+        node->kind = Node::Kind::operation;
+        node->op = op;
+        node->a = std::move(a);
+        node->b = std::move(b);
+        return node;
+    }
+
+    std::unique_ptr<Node> parseExpression() {
+        auto left = parseTerm();
+        for (;;) {
+            if (match('+')) left = makeOperation(Op::add, std::move(left), parseTerm());
+            else if (match('-')) left = makeOperation(Op::subtract, std::move(left), parseTerm());
+            else return left;
+        }
+    }
+
+    std::unique_ptr<Node> parseTerm() {
+        auto left = parseUnary();
+        for (;;) {
+            if (match('*')) left = makeOperation(Op::multiply, std::move(left), parseUnary());
+            else if (match('/')) left = makeOperation(Op::divide, std::move(left), parseUnary());
+            else if (match('%')) left = makeOperation(Op::modulo, std::move(left), parseUnary());
+            else return left;
+        }
+    }
+
+    std::unique_ptr<Node> parseUnary() {
+        if (match('-')) return makeOperation(Op::negate, parseUnary());
+        if (match('+')) return parseUnary();
+        return parsePower();
+    }
+
+    std::unique_ptr<Node> parsePower() {
+        auto base = parsePrimary();
+        if (match('^')) return makeOperation(Op::power, std::move(base), parseUnary());
+        return base;
+    }
+
+    std::unique_ptr<Node> parsePrimary() {
+        skipWhitespace();
+
+        if (match('(')) {
+            auto inner = parseExpression();
+            if (!match(')')) fail("Missing ')'");
+            return inner;
+        }
+
+        if (position.isDigit() || *position == '.') {
+            auto start = position;
+            while (position.isDigit() || *position == '.') ++position;
+            if (*position == 'e' || *position == 'E') {
+                auto exponent = position + 1;
+                if (*exponent == '-' || *exponent == '+') ++exponent;
+                if (exponent.isDigit()) {
+                    position = exponent;
+                    while (position.isDigit()) ++position;
+                }
+            }
+            return makeConstant(juce::String(start, position).getDoubleValue());
+        }
+
+        if (position.isLetter()) {
+            auto start = position;
+            while (position.isLetterOrDigit() || *position == '_') ++position;
+            const auto name = juce::String(start, position).toLowerCase();
+
+            if (match('(')) return parseCall(name);
+            if (name == "t") {
+                auto node = std::make_unique<Node>();
+                node->kind = Node::Kind::time;
+                return node;
+            }
+            if (name == "pi") return makeConstant(juce::MathConstants<double>::pi);
+            if (name == "tau") return makeConstant(juce::MathConstants<double>::twoPi);
+            if (name == "e") return makeConstant(juce::MathConstants<double>::euler);
+            fail("Unknown name '" + name + "'");
+            return makeConstant(0.0);
+        }
+
+        fail(position.isEmpty() ? juce::String("Unexpected end of expression")
+                                : "Unexpected '" + juce::String::charToString(*position) + "'");
+        return makeConstant(0.0);
+    }
+
+    std::unique_ptr<Node> parseCall(const juce::String& name) {
+        std::vector<std::unique_ptr<Node>> args;
+        if (!match(')')) {
+            do {
+                args.push_back(parseExpression());
+            } while (errorMessage.isEmpty() && match(','));
+            if (!match(')')) fail("Missing ')' after arguments to " + name);
+        }
+        if (errorMessage.isNotEmpty()) return makeConstant(0.0);
+
+        static const std::pair<const char*, Op> unaryFunctions[] = {
+            { "sin", Op::sin }, { "cos", Op::cos }, { "tan", Op::tan }, { "abs", Op::abs },
+            { "sqrt", Op::sqrt }, { "exp", Op::exp }, { "log", Op::log }, { "floor", Op::floor },
+            { "frac", Op::frac }, { "sign", Op::sign }, { "tri", Op::tri }, { "saw", Op::saw },
+            { "square", Op::square }
+        };
+        static const std::pair<const char*, Op> binaryFunctions[] = {
+            { "min", Op::minimum }, { "max", Op::maximum }, { "pow", Op::power }, { "noise", Op::noise },
+            { "gnoise", Op::gradientNoise }
+        };
+
+        for (const auto& function : unaryFunctions) {
+            if (name == function.first) {
+                if (args.size() != 1) break;
+                return makeOperation(function.second, std::move(args[0]));
+            }
+        }
+        for (const auto& function : binaryFunctions) {
+            if (name == function.first) {
+                if (args.size() != 2) break;
+                return makeOperation(function.second, std::move(args[0]), std::move(args[1]));
+            }
+        }
+        if (name == "clamp" && args.size() == 3) {
+            auto upper = makeOperation(Op::minimum, std::move(args[0]), std::move(args[2]));
+            return makeOperation(Op::maximum, std::move(upper), std::move(args[1]));
+        }
+
+        fail("Unknown function or wrong argument count: " + name + "()");
+        return makeConstant(0.0);
+    }
+
+    int allocateRegister() {
+        for (int i = 1; i < CurveExpression::maxRegisters; ++i) {
+            if (!registerUsed[(size_t)i]) {
+                registerUsed[(size_t)i] = true;
+                return i;
+            }
+        }
+        fail("Expression is too complex");
+        return 1;
+    }
+
+    void release(const CurveExpression::Operand& operand) {
+        if (operand.reg > 0) registerUsed[(size_t)operand.reg] = false;
+    }
+
+    CurveExpression::Operand generate(const Node& node, std::vector<CurveExpression::Instruction>& code) {
+        CurveExpression::Operand operand;
+        if (node.kind == Node::Kind::constant) {
+            operand.constant = node.value;
+            return operand;
+        }
+        if (node.kind == Node::Kind::time) {
+            operand.reg = 0;
+            return operand;
+        }
+
+        auto a = generate(*node.a, code);
+        CurveExpression::Operand b;
+        if (node.b != nullptr) b = generate(*node.b, code);
+
+        // Elementwise ops can write over their own inputs
+        release(a);
+        release(b);
+        operand.reg = allocateRegister();
+        code.push_back({ node.op, operand.reg, a, b });
+        return operand;
+    }
+};
+
+//==============================================================================
+std::unique_ptr<CurveExpression> CurveExpression::compile(const juce::String& text, juce::String& error) {
+    ExpressionCompiler compiler(text);
+    return compiler.compile(error);
+}
+
+void CurveExpression::evaluate(double startTime, double increment, int numSamples, float* output, double* workspace) const {
+    double* regs[maxRegisters];
+    for (int r = 0; r < maxRegisters; ++r)
+        regs[r] = workspace + r * maxBlockSize;
+
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize) {
+        const int num = juce::jmin(maxBlockSize, numSamples - offset);
+
+        if (result.isConstant()) {
+            juce::FloatVectorOperations::fill(output + offset, static_cast<float>(result.constant), num);
+            continue;
+        }
+
+        for (int i = 0; i < num; ++i)
+            regs[0][i] = startTime + (offset + i) * increment;
+
+        for (const auto& in : instructions) {
+            switch (in.op) {
+            case Op::add:      runBlock(in, regs, num, [](double a, double b) { return a + b; }); break;
+            case Op::subtract: runBlock(in, regs, num, [](double a, double b) { return a - b; }); break;
+            case Op::multiply: runBlock(in, regs, num, [](double a, double b) { return a * b; }); break;
+            case Op::divide:   runBlock(in, regs, num, [](double a, double b) { return b != 0.0 ? a / b : 0.0; }); break;
+            case Op::minimum:  runBlock(in, regs, num, [](double a, double b) { return juce::jmin(a, b); }); break;
+            case Op::maximum:  runBlock(in, regs, num, [](double a, double b) { return juce::jmax(a, b); }); break;
+            case Op::sin:      runUnaryBlock(in, regs, num, [](double a) { return std::sin(a); }); break;
+            case Op::cos:      runUnaryBlock(in, regs, num, [](double a) { return std::cos(a); }); break;
+            case Op::negate:   runUnaryBlock(in, regs, num, [](double a) { return -a; }); break;
+            case Op::abs:      runUnaryBlock(in, regs, num, [](double a) { return std::abs(a); }); break;
+            case Op::noise:
+            case Op::gradientNoise:
+                if (!in.a.isConstant() && in.b.isConstant()) {
+                    const auto shape = in.op == Op::noise ? NoiseGenerator::Shape::value : NoiseGenerator::Shape::gradient;
+                    NoiseGenerator::generate(shape, toSeed(in.b.constant), regs[in.a.reg], regs[in.dest], num);
+                }
+                else {
+                    runBlock(in, regs, num, [op = in.op](double a, double b) { return applyOp(op, a, b); });
+                }
+                break;
+            default:
+                if (isUnary(in.op)) runUnaryBlock(in, regs, num, [op = in.op](double a) { return applyOp(op, a, 0.0); });
+                else runBlock(in, regs, num, [op = in.op](double a, double b) { return applyOp(op, a, b); });
+                break;
+            }
+        }
+
+        const double* value = regs[result.reg];
+        for (int i = 0; i < num; ++i)
+            output[offset + i] = static_cast<float>(value[i]);
+    }
+}
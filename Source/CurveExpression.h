@@ -0,0 +1,52 @@
+#pragma once
+#include <JuceHeader.h>
+
+// A compiled automation expression such as "0.8*sin(2*pi*0.25*t) + noise(t, 3)".
+// The source is parsed once into a tree, constant sub-expressions are folded, and the rest
+// is flattened into register instructions that each run over a whole block of 't' values,
+// so there is no per-sample interpretation.
+//
+// Variables: t (seconds). Constants: pi, tau, e.
+// Operators: + - * / % ^ and unary minus.
+// Functions: sin cos tan abs sqrt exp log floor frac sign, tri saw square (period 1, -1..1),
+//            min(a,b) max(a,b) pow(a,b) clamp(x,lo,hi), noise(x, seed) (value noise) and
+//            gnoise(x, seed) (Perlin-style), both from NoiseGenerator.
+class CurveExpression {
+public:
+    static constexpr int maxBlockSize = 128;
+    static constexpr int maxRegisters = 32;
+    static constexpr int workspaceSize = maxBlockSize * maxRegisters;
+
+    // Returns nullptr and fills 'error' if the source doesn't parse
+    static std::unique_ptr<CurveExpression> compile(const juce::String& source, juce::String& error);
+
+    const juce::String& getSource() const noexcept { return source; }
+    bool isConstant() const noexcept { return instructions.empty() && result.isConstant(); }
+    int getNumInstructions() const noexcept { return static_cast<int>(instructions.size()); }
+
+    // Evaluates at startTime + i * increment for i in [0, numSamples). Real-time safe;
+    // 'workspace' must hold workspaceSize doubles. Blocks longer than maxBlockSize are split.
+    void evaluate(double startTime, double increment, int numSamples, float* output, double* workspace) const;
+
+    enum class Op { add, subtract, multiply, divide, modulo, power, minimum, maximum, noise, gradientNoise,
+                    negate, sin, cos, tan, abs, sqrt, exp, log, floor, frac, sign, tri, saw, square };
+
+    struct Operand {
+        int reg = -1;           // register index, or -1 for a constant
+        double constant = 0.0;
+        bool isConstant() const noexcept { return reg < 0; }
+    };
+
+    struct Instruction {
+        Op op;
+        int dest;
+        Operand a, b;
+    };
+
+private:
+    juce::String source;
+    std::vector<Instruction> instructions;
+    Operand result;
+
+    friend class ExpressionCompiler;
+};
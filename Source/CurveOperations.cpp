@@ -0,0 +1,145 @@
+#include "CurveOperations.h"
+
+juce::String CurveOperation::getName() const {
+    switch (type) {
+    case Type::scaleTime:    return "Scale Time";
+    case Type::offsetTime:   return "Offset Time";
+    case Type::scaleValue:   return "Scale Value";
+    case Type::invertValue:  return "Invert Value";
+    case Type::quantiseTime: return "Quantise Time";
+    case Type::simplify:     return "Simplify Curve";
+    case Type::crossfade:    return "Crossfade Curves";
+    }
+    return {};
+}
+
+namespace {
+    // Linear interpolation of 'curve' at ascending times, advancing a single cursor
+    void crossfadeTowards(const BreakpointTable& curve, const double* times, double* values, int num, double amount) {
+        if (curve.empty()) return;
+
+        const auto target = curve.toVector();
+        size_t cursor = 0;
+        for (int i = 0; i < num; ++i) {
+            const double t = times[i];
+            while (cursor + 1 < target.size() && t > target[cursor + 1].time) ++cursor;
+
+            double targetValue = target.back().value;
+            if (t <= target.front().time) {
+                targetValue = target.front().value;
+            }
+            else if (cursor + 1 < target.size()) {
+                const auto& left = target[cursor];
+                const auto& right = target[cursor + 1];
+                const double span = right.time - left.time;
+                targetValue = span > 0.0 ? left.value + (right.value - left.value) * (t - left.time) / span : right.value;
+            }
+            values[i] += (targetValue - values[i]) * amount;
+        }
+    }
+}
+
+void CurveOperations::simplify(std::vector<double>& times, std::vector<double>& values, double tolerance) {
+    const size_t num = times.size();
+    if (num < 3) return;
+
+    std::vector<char> keep(num, 0);
+    keep.front() = keep.back() = 1;
+
+    std::vector<std::pair<size_t, size_t>> segments{ { 0, num - 1 } };
+    while (!segments.empty()) {
+        auto [first, last] = segments.back();
+        segments.pop_back();
+        if (last <= first + 1) continue;
+
+        const double span = times[last] - times[first];
+        const double slope = span > 0.0 ? (values[last] - values[first]) / span : 0.0;
+
+        double maxDeviation = 0.0;
+        size_t furthest = first;
+        for (size_t i = first + 1; i < last; ++i) {
+            double deviation = std::abs(values[i] - (values[first] + slope * (times[i] - times[first])));
+            if (deviation > maxDeviation) {
+                maxDeviation = deviation;
+                furthest = i;
+            }
+        }
+
+        if (maxDeviation > tolerance) {
+            keep[furthest] = 1;
+            segments.push_back({ first, furthest });
+            segments.push_back({ furthest, last });
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < num; ++i) {
+        if (keep[i]) {
+            times[kept] = times[i];
+            values[kept] = values[i];
+            ++kept;
+        }
+    }
+    times.resize(kept);
+    values.resize(kept);
+}
+
+BreakpointTable CurveOperations::apply(const BreakpointTable& table, size_t startIndex, size_t endIndex,
+                                       const CurveOperation& operation) {
+    // Only the selection is unpacked; the table rebuilds just the chunks it touches
+    const auto selected = table.toVector(startIndex, endIndex);
+    if (selected.empty()) return table;
+
+    const size_t count = selected.size();
+    std::vector<double> times(count), values(count);
+    for (size_t i = 0; i < count; ++i) {
+        times[i] = selected[i].time;
+        values[i] = selected[i].value;
+    }
+
+    auto* t = times.data();
+    auto* v = values.data();
+    const int num = static_cast<int>(count);
+    const double anchor = times.front();
+
+    switch (operation.type) {
+    case CurveOperation::Type::scaleTime:
+        juce::FloatVectorOperations::add(t, -anchor, num);
+        juce::FloatVectorOperations::multiply(t, juce::jmax(0.0, operation.amount), num);
+        juce::FloatVectorOperations::add(t, anchor, num);
+        break;
+    case CurveOperation::Type::offsetTime:
+        juce::FloatVectorOperations::add(t, operation.amount, num);
+        juce::FloatVectorOperations::max(t, t, 0.0, num);
+        break;
+    case CurveOperation::Type::scaleValue:
+        juce::FloatVectorOperations::multiply(v, operation.amount, num);
+        break;
+    case CurveOperation::Type::invertValue:
+        juce::FloatVectorOperations::negate(v, v, num);
+        break;
+    case CurveOperation::Type::quantiseTime:
+        if (operation.amount > 0.0) {
+            const double grid = operation.amount;
+            const double inverseGrid = 1.0 / grid;
+            for (int i = 0; i < num; ++i)
+                t[i] = std::round(t[i] * inverseGrid) * grid;
+        }
+        break;
+    case CurveOperation::Type::simplify:
+        simplify(times, values, juce::jmax(0.0, operation.amount));
+        break;
+    case CurveOperation::Type::crossfade:
+        crossfadeTowards(operation.other, t, v, num, juce::jlimit(0.0, 1.0, operation.amount));
+        break;
+    }
+
+    juce::FloatVectorOperations::clip(values.data(), values.data(), -1.0, 1.0, static_cast<int>(values.size()));
+
+    // Every operation keeps the selection in time order, but time edits can carry it past its
+    // unselected neighbours; withReplaced merges those in
+    std::vector<Breakpoint> edited(times.size());
+    for (size_t i = 0; i < times.size(); ++i)
+        edited[i] = { times[i], values[i] };
+    return table.withReplaced(startIndex, startIndex + count, edited);
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <JuceHeader.h>
+#include "BreakpointTable.h"
+
+// Bulk edits over a range of breakpoints. The selected points are unpacked into separate
+// time and value arrays so each operation is a straight pass over contiguous doubles.
+struct CurveOperation {
+    enum class Type { scaleTime, offsetTime, scaleValue, invertValue, quantiseTime, simplify, crossfade };
+
+    Type type = Type::scaleTime;
+    double amount = 1.0;     // factor, offset, grid size, tolerance or crossfade position
+    BreakpointTable other;   // crossfade target
+
+    juce::String getName() const;
+};
+
+namespace CurveOperations {
+    // Applies 'operation' to the points in [startIndex, endIndex) and returns the edited table
+    BreakpointTable apply(const BreakpointTable& table, size_t startIndex, size_t endIndex, const CurveOperation& operation);
+
+    // Ramer-Douglas-Peucker: keeps the end points and every point deviating more than 'tolerance'
+    void simplify(std::vector<double>& times, std::vector<double>& values, double tolerance);
+}
@@ -0,0 +1,235 @@
+#include "GainPrefetcher.h"
+
+namespace {
+    bool canPrefetch(const CurveData& curve) {
+        const bool hasPan = !curve.pan.empty() || curve.expressions[CurveData::panExpression] != nullptr;
+        const bool hasWidth = (curve.lanes != nullptr && curve.lanes->hasLane(AutomationLanes::widthLane))
+            || curve.expressions[(size_t)(CurveData::laneExpressions + AutomationLanes::widthLane)] != nullptr;
+        return hasPan && !hasWidth;
+    }
+}
+
+// Fills every running instance's ring, so a session full of panners runs one thread rather than
+// one each. It sleeps until an instance with Lookahead on has a curve to prefetch, then polls.
+class GainPrefetcher::Worker : private juce::Thread {
+public:
+    Worker() : juce::Thread("Gain Prefetcher") { startThread(); }
+
+    ~Worker() override {
+        signalThreadShouldExit();
+        wakeUp.signal();
+        stopThread(2000);
+    }
+
+    void add(GainPrefetcher* prefetcher) {
+        const juce::ScopedLock sl(lock);
+        prefetchers.add(prefetcher);
+    }
+
+    // Returns once the thread is no longer filling 'prefetcher'
+    void remove(GainPrefetcher* prefetcher) {
+        const juce::ScopedLock sl(lock);
+        prefetchers.removeFirstMatchingValue(prefetcher);
+    }
+
+    void wake() { wakeUp.signal(); }
+
+private:
+    juce::CriticalSection lock;
+    juce::Array<GainPrefetcher*> prefetchers;
+    juce::WaitableEvent wakeUp;
+
+    void run() override {
+        while (!threadShouldExit()) {
+            bool anyPrefetching = false;
+            {
+                const juce::ScopedLock sl(lock);
+                for (auto* prefetcher : prefetchers) {
+                    if (prefetcher->isEnabled() && prefetcher->fill())
+                        anyPrefetching = true;
+                }
+            }
+            wakeUp.wait(anyPrefetching ? pollIntervalMs : -1);
+        }
+    }
+};
+
+GainPrefetcher::GainPrefetcher(GainRenderer renderer, const std::atomic<float>& lawParameter)
+    : renderGains(std::move(renderer)), law(lawParameter) {}
+
+GainPrefetcher::~GainPrefetcher() {
+    stop();
+}
+
+void GainPrefetcher::start(double newSampleRate) {
+    stop();
+
+    // Neither the audio thread nor the worker is using the ring now
+    sampleRate = newSampleRate;
+    fifo.reset();
+    restartPosition = 0;
+    restartRequestedAt = 0;
+    workerGeneration = generation.load();
+    ++generation;
+    workerRevision = -1;
+    running = true;
+    worker->add(this);
+    worker->wake();
+}
+
+void GainPrefetcher::stop() {
+    running = false;
+    worker->remove(this);
+}
+
+void GainPrefetcher::setEnabled(bool shouldPrefetch) {
+    enabled = shouldPrefetch;
+    if (shouldPrefetch)
+        worker->wake();
+}
+
+void GainPrefetcher::setCurve(const CurveData& newCurve, int newRevision) {
+    {
+        const juce::ScopedLock sl(curveLock);
+        pendingCurve = newCurve;
+        pendingRevision = newRevision;
+        curveSupported = canPrefetch(newCurve);
+    }
+    worker->wake();
+}
+
+void GainPrefetcher::requestRestart(juce::int64 playhead, juce::int64 restartAt) {
+    // Whatever is queued is stale now; the worker notices the new generation before its next chunk
+    fifo.finishedRead(fifo.getNumReady());
+    restartRequestedAt = playhead;
+    restartPosition.store(restartAt, std::memory_order_relaxed);
+    generation.fetch_add(1, std::memory_order_release);
+}
+
+bool GainPrefetcher::read(juce::int64 position, int numSamples, int revision, bool constantPower, float* left, float* right) {
+    const auto currentGeneration = generation.load(std::memory_order_relaxed);
+    int copied = 0;
+
+    while (copied < numSamples) {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(1, start1, size1, start2, size2);
+        const juce::int64 expected = position + copied;
+
+        if (size1 == 0) {
+            // Underrun: either the worker is still heading for the restart point, or it's fallen
+            // behind, or the playhead went back past where the restart was asked for
+            if (expected >= restartPosition.load(std::memory_order_relaxed) || position < restartRequestedAt)
+                requestRestart(position, position + numSamples + restartLead);
+            return false;
+        }
+
+        const Chunk& chunk = ring[(size_t)start1];
+        if (chunk.generation != currentGeneration || expected >= chunk.start + chunkSize) {
+            fifo.finishedRead(1); // left over from before a restart, or already played
+            continue;
+        }
+        if (chunk.revision != revision || chunk.constantPower != constantPower) {
+            requestRestart(position, position + numSamples + restartLead); // edit or law change
+            return false;
+        }
+        if (expected < chunk.start) {
+            // Still short of the restart point (or the host is calling while stopped): render inline
+            // and wait. Only a jump back to before where the restart was asked for is a real seek.
+            if (chunk.start != restartPosition.load(std::memory_order_relaxed) || position < restartRequestedAt)
+                requestRestart(position, position + numSamples + restartLead);
+            return false;
+        }
+
+        const int offsetInChunk = static_cast<int>(expected - chunk.start);
+        const int count = juce::jmin(chunkSize - offsetInChunk, numSamples - copied);
+        std::copy(chunk.left + offsetInChunk, chunk.left + offsetInChunk + count, left + copied);
+        std::copy(chunk.right + offsetInChunk, chunk.right + offsetInChunk + count, right + copied);
+        copied += count;
+        if (offsetInChunk + count == chunkSize)
+            fifo.finishedRead(1);
+    }
+
+    ++blocksServed;
+    return true;
+}
+
+bool GainPrefetcher::fill() {
+    bool curveChanged = false;
+    {
+        const juce::ScopedLock sl(curveLock);
+        if (pendingRevision != workerRevision) {
+            workerCurve = pendingCurve;
+            workerRevision = pendingRevision;
+            panCursor = laneCursor = 0;
+            preparedCursor = {};
+            curveChanged = true;
+        }
+    }
+
+    // Taken from the curve's shared set at the playback rate, so it's the same object processBlock
+    // renders inline and both paths give the same samples. start() makes every new rate a new curve.
+    if (curveChanged)
+        workerPrepared = workerCurve.prepared != nullptr ? workerCurve.prepared->get(sampleRate) : nullptr;
+    if (!canPrefetch(workerCurve)) return false;
+
+    while (fifo.getFreeSpace() > 0) {
+        const auto latestGeneration = generation.load(std::memory_order_acquire);
+        if (latestGeneration != workerGeneration) {
+            workerGeneration = latestGeneration;
+            workerPosition = restartPosition.load(std::memory_order_relaxed);
+        }
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+        auto& chunk = ring[(size_t)start1];
+        chunk.start = workerPosition;
+        chunk.generation = workerGeneration;
+        chunk.revision = workerRevision;
+        chunk.constantPower = law.load() > 0.5f;
+        renderChunk(chunk);
+        fifo.finishedWrite(1);
+        workerPosition += chunkSize;
+    }
+    return true;
+}
+
+void GainPrefetcher::renderChunk(Chunk& chunk) {
+    float pan[chunkSize];
+    float laneBuffers[AutomationLanes::numLanes][chunkSize];
+    const double startTime = static_cast<double>(chunk.start) / sampleRate;
+    const double increment = 1.0 / sampleRate;
+
+    if (const auto& expression = workerCurve.expressions[CurveData::panExpression]) {
+        expression->evaluate(startTime, increment, chunkSize, pan, workspace.data());
+        juce::FloatVectorOperations::clip(pan, pan, -1.0f, 1.0f, chunkSize);
+    }
+    else if (workerPrepared != nullptr && !workerPrepared->empty()) {
+        workerPrepared->render(chunk.start, chunkSize, preparedCursor, pan);
+    }
+    else {
+        for (int i = 0; i < chunkSize; ++i)
+            pan[i] = workerCurve.pan.size() < 2 ? 0.0f : static_cast<float>(workerCurve.pan.getValueAt(startTime + i * increment, panCursor));
+    }
+
+    float* laneValues[AutomationLanes::numLanes] = {};
+    if (workerCurve.lanes != nullptr) {
+        for (int lane = 0; lane < AutomationLanes::numLanes; ++lane) {
+            if (workerCurve.lanes->hasLane(lane)) laneValues[lane] = laneBuffers[lane];
+        }
+        workerCurve.lanes->render(startTime, increment, chunkSize, laneCursor, laneValues);
+    }
+    for (int lane = 0; lane < AutomationLanes::numLanes; ++lane) {
+        if (const auto& expression = workerCurve.expressions[(size_t)(CurveData::laneExpressions + lane)]) {
+            const auto range = AutomationLanes::getValueRange(lane);
+            laneValues[lane] = laneBuffers[lane];
+            expression->evaluate(startTime, increment, chunkSize, laneValues[lane], workspace.data());
+            juce::FloatVectorOperations::clip(laneValues[lane], laneValues[lane], range.getStart(), range.getEnd(), chunkSize);
+        }
+    }
+
+    renderGains(pan, laneValues[AutomationLanes::lawLane], chunk.left, chunk.right, chunkSize, chunk.constantPower);
+    if (auto* gain = laneValues[AutomationLanes::gainLane]) {
+        juce::FloatVectorOperations::multiply(chunk.left, gain, chunkSize);
+        juce::FloatVectorOperations::multiply(chunk.right, gain, chunkSize);
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <JuceHeader.h>
+#include "CurveData.h"
+
+// Optional lookahead mode: a worker thread renders the curve's left/right gain envelope ahead
+// of the playhead into a single-producer/single-consumer ring, so processBlock only copies and
+// multiplies. The ring holds fixed-size chunks tagged with their sample position, curve revision
+// and pan law; the audio thread drops stale chunks and, on a seek, edit or law change, asks the
+// worker to restart a little ahead of the playhead while it renders inline until the worker is back.
+//
+// One worker thread serves every instance. While any instance has Lookahead on it tops up their
+// rings every pollIntervalMs, and otherwise it sleeps. The audio thread never wakes it, since
+// signalling an event takes a lock: it only reads and writes atomics.
+//
+// Only curves whose gains don't depend on real-time input can be prefetched: a pan curve or
+// expression, optionally with gain and law lanes. Width lanes and lane-only files aren't.
+class GainPrefetcher {
+public:
+    using GainRenderer = std::function<void(const float* pan, const float* lawMix, float* left, float* right,
+                                            int numSamples, bool constantPower)>;
+
+    static constexpr int chunkSize = 32;
+    static constexpr int numChunks = 128;                  // up to 4064 samples ahead
+    static constexpr int restartLead = 32 * chunkSize;     // how far ahead of the playhead a restart begins
+    static constexpr int pollIntervalMs = 5;               // while any instance prefetches
+
+    GainPrefetcher(GainRenderer renderer, const std::atomic<float>& lawParameter);
+    ~GainPrefetcher();
+
+    // prepareToPlay / releaseResources, while the audio thread isn't running
+    void start(double sampleRate);
+    void stop();
+
+    // Message thread: the Lookahead switch. While it's off the worker skips this instance.
+    void setEnabled(bool shouldPrefetch);
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+    void setCurve(const CurveData& curve, int revision);
+
+    // Audio thread: true when gains can currently come from the ring at all
+    bool isActive() const noexcept {
+        return running.load(std::memory_order_relaxed) && enabled.load(std::memory_order_relaxed)
+            && curveSupported.load(std::memory_order_relaxed);
+    }
+
+    // Audio thread: copies the gains for samples [position, position + numSamples). Returns false
+    // when they aren't ready or don't match, and the caller renders the block itself.
+    bool read(juce::int64 position, int numSamples, int revision, bool constantPower, float* left, float* right);
+
+    // Blocks read() served from the ring; only ever grows
+    juce::int64 getNumBlocksServed() const noexcept { return blocksServed.load(std::memory_order_relaxed); }
+
+private:
+    struct Chunk {
+        juce::int64 start = 0;
+        juce::uint32 generation = 0;
+        int revision = 0;
+        bool constantPower = false;
+        float left[chunkSize];
+        float right[chunkSize];
+    };
+
+    class Worker;
+
+    GainRenderer renderGains;
+    const std::atomic<float>& law;
+    std::atomic<bool> running{ false };
+    std::atomic<bool> enabled{ false };
+    std::atomic<bool> curveSupported{ false };
+    double sampleRate = 44100.0;
+
+    // Ring shared by the two threads; generation and restartPosition are written by the audio thread only
+    std::vector<Chunk> ring = std::vector<Chunk>(numChunks);
+    juce::AbstractFifo fifo{ numChunks };
+    std::atomic<juce::int64> restartPosition{ 0 };
+    std::atomic<juce::uint32> generation{ 0 };
+    juce::int64 restartRequestedAt = 0; // playhead when the last restart was asked for; audio thread only
+    std::atomic<juce::int64> blocksServed{ 0 };
+
+    // Curve snapshot handed over by the message thread
+    juce::CriticalSection curveLock;
+    CurveData pendingCurve;
+    int pendingRevision = 0;
+
+    // The worker's side, only touched while filling this instance (or while it's stopped)
+    CurveData workerCurve;
+    std::shared_ptr<const PreparedCurve> workerPrepared; // the same one processBlock renders inline
+    PreparedCurve::Cursor preparedCursor;
+    int workerRevision = -1;
+    juce::uint32 workerGeneration = 0;
+    juce::int64 workerPosition = 0;
+    size_t panCursor = 0, laneCursor = 0;
+    std::vector<double> workspace = std::vector<double>(CurveExpression::workspaceSize);
+
+    juce::SharedResourcePointer<Worker> worker;
+
+    void requestRestart(juce::int64 playhead, juce::int64 restartAt);
+    bool fill(); // renders until the ring is full; false if this instance has nothing to prefetch
+    void renderChunk(Chunk& chunk);
+};
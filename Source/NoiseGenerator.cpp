@@ -0,0 +1,71 @@
+#include "NoiseGenerator.h"
+
+namespace NoiseGenerator {
+    namespace {
+        juce::uint64 latticeIndex(double cell) noexcept {
+            return static_cast<juce::uint64>(static_cast<juce::int64>(cell));
+        }
+
+        double valueAt(double x, juce::uint64 seed) noexcept {
+            const double cell = std::floor(x);
+            const double f = x - cell;
+            const double smooth = f * f * (3.0 - 2.0 * f);
+            const double left = uniform(seed, latticeIndex(cell));
+            const double right = uniform(seed, latticeIndex(cell) + 1);
+            return left + (right - left) * smooth;
+        }
+
+        double gradientAt(double x, juce::uint64 seed) noexcept {
+            const double cell = std::floor(x);
+            const double f = x - cell;
+            const double fade = f * f * f * (f * (f * 6.0 - 15.0) + 10.0);
+            const double left = uniform(seed, latticeIndex(cell)) * f;
+            const double right = uniform(seed, latticeIndex(cell) + 1) * (f - 1.0);
+            // A slope of at most 1 over half a cell peaks at 0.5, so scale back up to -1..1
+            return juce::jlimit(-1.0, 1.0, 2.0 * (left + (right - left) * fade));
+        }
+
+        double whiteAt(double x, juce::uint64 seed) noexcept {
+            return uniform(seed, latticeIndex(std::floor(x)));
+        }
+
+        template <typename Fn>
+        void fill(const double* x, double* output, int numValues, Fn&& fn) {
+            for (int i = 0; i < numValues; ++i)
+                output[i] = fn(x[i]);
+        }
+    }
+
+    double value(double x, juce::uint64 seed) noexcept { return valueAt(x, seed); }
+    double gradient(double x, juce::uint64 seed) noexcept { return gradientAt(x, seed); }
+
+    void generateWhite(juce::uint64 seed, juce::uint64 firstCounter, float* output, int numValues) {
+        for (int i = 0; i < numValues; ++i)
+            output[i] = uniform(seed, firstCounter + static_cast<juce::uint64>(i));
+    }
+
+    void generate(Shape shape, juce::uint64 seed, double startX, double increment, float* output, int numValues) {
+        switch (shape) {
+        case Shape::white:
+            for (int i = 0; i < numValues; ++i)
+                output[i] = static_cast<float>(whiteAt(startX + i * increment, seed));
+            break;
+        case Shape::value:
+            for (int i = 0; i < numValues; ++i)
+                output[i] = static_cast<float>(valueAt(startX + i * increment, seed));
+            break;
+        case Shape::gradient:
+            for (int i = 0; i < numValues; ++i)
+                output[i] = static_cast<float>(gradientAt(startX + i * increment, seed));
+            break;
+        }
+    }
+
+    void generate(Shape shape, juce::uint64 seed, const double* x, double* output, int numValues) {
+        switch (shape) {
+        case Shape::white:    fill(x, output, numValues, [seed](double v) { return whiteAt(v, seed); }); break;
+        case Shape::value:    fill(x, output, numValues, [seed](double v) { return valueAt(v, seed); }); break;
+        case Shape::gradient: fill(x, output, numValues, [seed](double v) { return gradientAt(v, seed); }); break;
+        }
+    }
+}
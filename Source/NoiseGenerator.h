@@ -0,0 +1,40 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Counter-based noise: value n of a stream depends only on (seed, n), never on what was
+// generated before, so a curve is identical on every machine for the same seed and any
+// range can be generated independently. The bulk functions have no loop-carried state,
+// which lets the compiler vectorise them.
+namespace NoiseGenerator {
+    enum class Shape {
+        white,    // an independent value per point
+        value,    // random values at integer x, smoothly interpolated
+        gradient  // Perlin-style: random slopes at integer x, smoother and without plateaus
+    };
+
+    // 64-bit hash of (seed, counter)
+    inline juce::uint64 hash(juce::uint64 seed, juce::uint64 counter) noexcept {
+        juce::uint64 z = (counter + 1) * 0x9E3779B97F4A7C15ull ^ (seed * 0xD1B54A32D192ED03ull + 0x2545F4914F6CDD1Dull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // -1..1, uniformly distributed
+    inline float uniform(juce::uint64 seed, juce::uint64 counter) noexcept {
+        return static_cast<float>(hash(seed, counter) >> 40) * (2.0f / 16777216.0f) - 1.0f;
+    }
+
+    // Smooth noise at an arbitrary position, range -1..1
+    double value(double x, juce::uint64 seed) noexcept;
+    double gradient(double x, juce::uint64 seed) noexcept;
+
+    // output[i] = uniform(seed, firstCounter + i)
+    void generateWhite(juce::uint64 seed, juce::uint64 firstCounter, float* output, int numValues);
+
+    // output[i] = noise at startX + i * increment, for any shape (white uses floor(x) as the counter)
+    void generate(Shape shape, juce::uint64 seed, double startX, double increment, float* output, int numValues);
+
+    // output[i] = noise at x[i]; used where positions aren't evenly spaced
+    void generate(Shape shape, juce::uint64 seed, const double* x, double* output, int numValues);
+}
@@ -0,0 +1,54 @@
+#include "ObjectLanes.h"
+
+ObjectLanes::ObjectLanes(int sources)
+    : numSources(juce::jlimit(1, maxSources, sources)), present((size_t)numSources, false) {}
+
+void ObjectLanes::addRow(double time, const float* sourceValues) {
+    jassert(times.empty() || time >= times.back());
+    const size_t previous = values.size();
+    times.push_back(time);
+    values.resize(previous + (size_t)numSources);
+
+    for (int source = 0; source < numSources; ++source) {
+        float value = sourceValues[source];
+        if (std::isnan(value))
+            value = previous == 0 ? 0.0f : values[previous - (size_t)numSources + (size_t)source];
+        values[previous + (size_t)source] = juce::jlimit(-1.0f, 1.0f, value);
+    }
+}
+
+void ObjectLanes::render(double startTime, double increment, int numPoints, size_t& cursor, float* output, int outputStride) const {
+    const size_t numRows = times.size();
+    if (numRows == 0) return;
+
+    const size_t stride = (size_t)numSources;
+    const size_t numOutputs = (size_t)juce::jmin(numSources, outputStride);
+    cursor = juce::jmin(cursor, numRows - 1);
+    double time = startTime;
+
+    for (int k = 0; k < numPoints; ++k) {
+        if ((cursor > 0 && time < times[cursor]) || (cursor + 2 < numRows && time > times[cursor + 2])) {
+            auto it = std::lower_bound(times.begin(), times.end(), time);
+            auto index = static_cast<size_t>(it - times.begin());
+            cursor = index > 0 ? index - 1 : 0;
+        }
+        while (cursor + 1 < numRows && time > times[cursor + 1]) ++cursor;
+
+        float* out = output + (size_t)k * (size_t)outputStride;
+        const float* left = values.data() + cursor * stride;
+
+        if (cursor + 1 >= numRows || time <= times[cursor]) {
+            const float* row = time <= times[cursor] ? left : values.data() + (numRows - 1) * stride;
+            std::copy(row, row + numOutputs, out);
+        }
+        else {
+            // All sources at once: out = left + (right - left) * fraction
+            const float* right = left + stride;
+            const double span = times[cursor + 1] - times[cursor];
+            const float fraction = span > 0.0 ? static_cast<float>((time - times[cursor]) / span) : 1.0f;
+            for (size_t s = 0; s < numOutputs; ++s)
+                out[s] = left[s] + (right[s] - left[s]) * fraction;
+        }
+        time += increment;
+    }
+}
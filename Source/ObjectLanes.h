@@ -0,0 +1,33 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Per-source pan lanes for object-bus mode, where each channel of the main input is a mono
+// source with its own curve ("obj1", "obj2", ... columns). Stored row-major: every row holds
+// all sources' values next to each other, so one interpolation step updates every source in
+// a single contiguous, vectorisable pass. Built once when a file is parsed, then immutable.
+class ObjectLanes {
+public:
+    static constexpr int maxSources = 128;
+
+    explicit ObjectLanes(int numSources);
+
+    // Rows must be added in time order; NaN repeats the source's previous value (centre at first)
+    void addRow(double time, const float* sourceValues);
+    void setSourcePresent(int source) { present[(size_t)source] = true; }
+
+    int getNumSources() const noexcept { return numSources; }
+    bool hasSource(int source) const noexcept { return source < numSources && present[(size_t)source]; }
+    size_t size() const noexcept { return times.size(); }
+    double getTime(size_t row) const { return times[row]; }
+    float getValue(int source, size_t row) const { return values[row * (size_t)numSources + (size_t)source]; }
+
+    // Audio thread: writes each source's pan at startTime + k * increment into
+    // output[k * outputStride + source], for the first outputStride sources. 'cursor' persists between calls.
+    void render(double startTime, double increment, int numPoints, size_t& cursor, float* output, int outputStride) const;
+
+private:
+    int numSources;
+    std::vector<double> times;
+    std::vector<float> values;
+    std::vector<bool> present;
+};
@@ -0,0 +1,204 @@
+#include "PanRecorder.h"
+
+void PanRecorder::Simplifier::add(double time, double value, std::vector<Breakpoint>& output) {
+    if (!hasAnchor) {
+        anchor = { time, value };
+        output.push_back(anchor);
+        hasAnchor = true;
+        hasLast = false;
+        return;
+    }
+    if (time <= anchor.time) return;
+
+    // Slopes from the anchor that pass within the tolerance of this value
+    double dt = time - anchor.time;
+    double lower = (value - tolerance - anchor.value) / dt;
+    double upper = (value + tolerance - anchor.value) / dt;
+
+    if (hasLast && (lower > maxSlope || upper < minSlope)) {
+        // The cone closed: end the line at the last time, on the slope closest to its value
+        const double slope = juce::jlimit(minSlope, maxSlope, (last.value - anchor.value) / (last.time - anchor.time));
+        anchor = { last.time, anchor.value + slope * (last.time - anchor.time) };
+        output.push_back(anchor);
+
+        dt = time - anchor.time;
+        lower = (value - tolerance - anchor.value) / dt;
+        upper = (value + tolerance - anchor.value) / dt;
+        hasLast = false;
+    }
+
+    minSlope = hasLast ? juce::jmax(minSlope, lower) : lower;
+    maxSlope = hasLast ? juce::jmin(maxSlope, upper) : upper;
+    last = { time, value };
+    hasLast = true;
+}
+
+void PanRecorder::Simplifier::finish(std::vector<Breakpoint>& output) {
+    if (hasLast) {
+        const double slope = juce::jlimit(minSlope, maxSlope, (last.value - anchor.value) / (last.time - anchor.time));
+        output.push_back({ last.time, anchor.value + slope * (last.time - anchor.time) });
+    }
+    hasAnchor = hasLast = false;
+}
+
+// Drains every instance's ring, so a session full of panners runs one thread rather than one
+// each. It sleeps until an instance starts recording and then drains every drainIntervalMs;
+// the audio thread never wakes it, since signalling an event takes a lock.
+class PanRecorder::DrainThread : private juce::Thread {
+public:
+    DrainThread() : juce::Thread("Pan Recorder") { startThread(); }
+
+    ~DrainThread() override {
+        signalThreadShouldExit();
+        wakeUp.signal();
+        stopThread(2000);
+    }
+
+    void add(PanRecorder* recorder) {
+        const juce::ScopedLock sl(lock);
+        recorders.add(recorder);
+    }
+
+    // Returns once the thread is no longer draining 'recorder'
+    void remove(PanRecorder* recorder) {
+        const juce::ScopedLock sl(lock);
+        recorders.removeFirstMatchingValue(recorder);
+    }
+
+    void wake() { wakeUp.signal(); }
+
+private:
+    juce::CriticalSection lock;
+    juce::Array<PanRecorder*> recorders;
+    juce::WaitableEvent wakeUp;
+
+    void run() override {
+        while (!threadShouldExit()) {
+            bool anyRecording = false;
+            {
+                const juce::ScopedLock sl(lock);
+                for (auto* recorder : recorders) {
+                    if (recorder->isRecording()) {
+                        recorder->drain();
+                        anyRecording = true;
+                    }
+                }
+            }
+            wakeUp.wait(anyRecording ? drainIntervalMs : -1);
+        }
+    }
+};
+
+PanRecorder::PanRecorder(PassCallback onPassFinished)
+    : passFinished(std::move(onPassFinished)) {
+    drainThread->add(this);
+}
+
+PanRecorder::~PanRecorder() {
+    recording = false;
+    drainThread->remove(this);
+    cancelPendingUpdate();
+}
+
+void PanRecorder::start(double sampleRate, float tolerance) {
+    stop();
+    {
+        // A new generation instead of fifo.reset(): the audio thread may still be pushing
+        const juce::ScopedLock sl(drainLock);
+        rate = sampleRate;
+        passTolerance = tolerance;
+        simplifier.reset(tolerance);
+        pass.clear();
+        acceptedGeneration = ++generation;
+        if (acceptedGeneration == 0) acceptedGeneration = ++generation; // 0 means stopped
+    }
+    dropped = 0;
+    recording = true;
+    drainThread->wake();
+}
+
+void PanRecorder::stop() {
+    recording = false;
+
+    // Closes the pass with whatever was pushed so far; anything pushed later is stale
+    const juce::ScopedLock sl(drainLock);
+    if (acceptedGeneration == 0) return;
+    drain();
+    finishPass();
+    acceptedGeneration = 0;
+}
+
+bool PanRecorder::write(Pair pair) noexcept {
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 == 0) {
+        ++dropped;
+        return false;
+    }
+    ring[(size_t)start1] = pair;
+    fifo.finishedWrite(1);
+    return true;
+}
+
+void PanRecorder::push(juce::int64 position, int numSamples, float pan) noexcept {
+    if (!recording.load(std::memory_order_relaxed)) return;
+
+    // Recording was restarted: this block opens the new generation's first pass
+    const auto current = generation.load(std::memory_order_acquire);
+    if (current != audioGeneration) {
+        audioGeneration = current;
+        nextPosition = -1;
+    }
+
+    if (position != nextPosition) endPass(); // seek or loop: the new position starts another pass
+    write({ position, pan, audioGeneration });
+    nextPosition = position + numSamples;
+}
+
+void PanRecorder::endPass() noexcept {
+    if (nextPosition >= 0 && write({ -1, 0.0f, audioGeneration }))
+        nextPosition = -1;
+}
+
+void PanRecorder::drain() {
+    const juce::ScopedLock sl(drainLock);
+    const double sampleRate = rate.load();
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    auto consume = [&](int start, int size) {
+        for (int i = start; i < start + size; ++i) {
+            const auto& pair = ring[(size_t)i];
+            if (pair.generation != acceptedGeneration)
+                continue;
+            if (pair.position < 0)
+                finishPass();
+            else
+                simplifier.add(static_cast<double>(pair.position) / sampleRate, pair.pan, pass);
+        }
+    };
+    consume(start1, size1);
+    consume(start2, size2);
+    fifo.finishedRead(size1 + size2);
+}
+
+void PanRecorder::finishPass() {
+    simplifier.finish(pass);
+    if (pass.size() >= 2) {
+        const juce::ScopedLock sl(finishedLock);
+        finishedPasses.push_back(std::move(pass));
+        triggerAsyncUpdate();
+    }
+    pass.clear();
+    simplifier.reset(passTolerance);
+}
+
+void PanRecorder::handleAsyncUpdate() {
+    std::vector<std::vector<Breakpoint>> passes;
+    {
+        const juce::ScopedLock sl(finishedLock);
+        std::swap(passes, finishedPasses);
+    }
+    for (auto& pass : passes)
+        passFinished(std::move(pass));
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <JuceHeader.h>
+#include "BreakpointTable.h"
+
+// Record mode: turns live pan moves (the Pan parameter, from the slider or host automation)
+// into breakpoints. The audio thread pushes one (sample position, pan) pair per block into a
+// lock-free ring and never allocates. One worker thread, shared by every instance, drains the
+// rings and simplifies each pass online: it keeps the cone of line slopes that stay within the
+// tolerance of every value since the last kept point, and only keeps a point when the cone
+// closes. Finished passes go to the message thread, which merges them into the curve.
+//
+// A pass ends when the transport stops, the playhead jumps, or recording is switched off.
+class PanRecorder : private juce::AsyncUpdater {
+public:
+    using PassCallback = std::function<void(std::vector<Breakpoint> points)>;
+
+    static constexpr int ringSize = 8192;           // pairs; one per block
+    static constexpr int drainIntervalMs = 50;      // while any instance records
+    static constexpr float defaultTolerance = 0.005f;
+
+    explicit PanRecorder(PassCallback onPassFinished);
+    ~PanRecorder() override;
+
+    // Message thread
+    void start(double sampleRate, float tolerance = defaultTolerance);
+    void stop(); // finishes the current pass
+    void setSampleRate(double sampleRate) { rate.store(sampleRate); }
+    bool isRecording() const noexcept { return recording.load(std::memory_order_relaxed); }
+    int getNumDropped() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+    // Audio thread: the block [position, position + numSamples) played at 'pan'
+    void push(juce::int64 position, int numSamples, float pan) noexcept;
+    void endPass() noexcept;
+
+private:
+    // A negative position ends the pass. 'generation' is the start() it was recorded under; the
+    // ring is never reset while the audio thread may be writing, so older pairs are skipped instead.
+    struct Pair { juce::int64 position; float pan; juce::uint32 generation; };
+
+    class DrainThread;
+
+    // Cone-intersection simplifier; every input value is within the tolerance of the output lines
+    class Simplifier {
+    public:
+        void reset(double newTolerance) { tolerance = newTolerance; hasAnchor = hasLast = false; }
+        void add(double time, double value, std::vector<Breakpoint>& output);
+        void finish(std::vector<Breakpoint>& output);
+
+    private:
+        double tolerance = 0.0;
+        Breakpoint anchor{}, last{};
+        bool hasAnchor = false, hasLast = false;
+        double minSlope = 0.0, maxSlope = 0.0;
+    };
+
+    PassCallback passFinished;
+    std::atomic<bool> recording{ false };
+    std::atomic<double> rate{ 44100.0 };
+    std::atomic<int> dropped{ 0 };
+    std::atomic<juce::uint32> generation{ 0 };
+
+    std::vector<Pair> ring = std::vector<Pair>(ringSize);
+    juce::AbstractFifo fifo{ ringSize };
+    juce::int64 nextPosition = -1;      // audio thread only
+    juce::uint32 audioGeneration = 0;   // audio thread only
+
+    // The ring's reading side: the shared thread drains it, stop() drains it one last time
+    juce::CriticalSection drainLock;
+    juce::uint32 acceptedGeneration = 0; // 0 while stopped
+    double passTolerance = defaultTolerance;
+    Simplifier simplifier;
+    std::vector<Breakpoint> pass;
+
+    juce::CriticalSection finishedLock;
+    std::vector<std::vector<Breakpoint>> finishedPasses;
+
+    juce::SharedResourcePointer<DrainThread> drainThread;
+
+    bool write(Pair pair) noexcept;
+    void drain();
+    void finishPass();
+    void handleAsyncUpdate() override;
+};
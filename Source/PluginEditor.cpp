@@ -21,6 +21,7 @@ PanningEditor::PanningEditor(PanningProcessor& p) :
     curveGenCombo.addItem("Ramp", 3);
     curveGenCombo.addItem("Random", 4);
     curveGenCombo.addItem("Bounce", 5);
+    curveGenCombo.addItem("Smooth Noise", smoothNoiseId);
     curveGenCombo.setSelectedId(1);
     curveGenCombo.addListener(this);
     addAndMakeVisible(curveGenCombo);
@@ -41,6 +42,80 @@ PanningEditor::PanningEditor(PanningProcessor& p) :
     generateButton.addListener(this);
     addAndMakeVisible(generateButton);
 
+    newSeedButton.setButtonText("New Noise Seed");
+    newSeedButton.addListener(this);
+    addAndMakeVisible(newSeedButton);
+
+    undoButton.setButtonText("Undo");
+    undoButton.addListener(this);
+    addAndMakeVisible(undoButton);
+
+    redoButton.setButtonText("Redo");
+    redoButton.addListener(this);
+    addAndMakeVisible(redoButton);
+
+    bulkOpCombo.addItem("Scale Time", 1);
+    bulkOpCombo.addItem("Offset Time", 2);
+    bulkOpCombo.addItem("Scale Value", 3);
+    bulkOpCombo.addItem("Invert Value", 4);
+    bulkOpCombo.addItem("Quantise Time", 5);
+    bulkOpCombo.addItem("Simplify", 6);
+    bulkOpCombo.addItem("Crossfade With Text", 7);
+    bulkOpCombo.setSelectedId(1, juce::dontSendNotification);
+    bulkOpCombo.addListener(this);
+    addAndMakeVisible(bulkOpCombo);
+
+    bulkAmountSlider.setRange(-10.0, 10.0, 0.001);
+    bulkAmountSlider.setValue(2.0, juce::dontSendNotification);
+    bulkAmountSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 24);
+    bulkAmountSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    addAndMakeVisible(bulkAmountSlider);
+
+    bulkApplyButton.setButtonText("Apply To Selection");
+    bulkApplyButton.addListener(this);
+    addAndMakeVisible(bulkApplyButton);
+
+    sidechainModeCombo.addItem("Sidechain Off", 1);
+    sidechainModeCombo.addItem("Sidechain Level", 2);
+    sidechainModeCombo.addItem("Sidechain Correlation", 3);
+    addAndMakeVisible(sidechainModeCombo);
+
+    sidechainAmountSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 24);
+    sidechainAmountSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    addAndMakeVisible(sidechainAmountSlider);
+
+    midiModeCombo.addItem("MIDI Pan Off", 1);
+    midiModeCombo.addItem("MIDI Pan CC", 2);
+    midiModeCombo.addItem("MPE Pitch Bend", 3);
+    midiModeCombo.addItem("MPE Timbre", 4);
+    addAndMakeVisible(midiModeCombo);
+
+    midiControllerSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 24);
+    midiControllerSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    addAndMakeVisible(midiControllerSlider);
+
+    noteRetriggerButton.setButtonText("Note Retrigger");
+    addAndMakeVisible(noteRetriggerButton);
+
+    recordButton.setButtonText("Record");
+    recordButton.setToggleState(processor.isRecording(), juce::dontSendNotification);
+    recordButton.addListener(this);
+    addAndMakeVisible(recordButton);
+
+    lookaheadButton.setButtonText("Lookahead");
+    lookaheadButton.setToggleState(processor.isLookaheadRendering(), juce::dontSendNotification);
+    lookaheadButton.addListener(this);
+    addAndMakeVisible(lookaheadButton);
+
+    statsButton.setButtonText("Stats");
+    statsButton.setToggleState(processor.getStats().isEnabled(), juce::dontSendNotification);
+    statsButton.addListener(this);
+    addAndMakeVisible(statsButton);
+
+    exportStatsButton.setButtonText("Export Stats");
+    exportStatsButton.addListener(this);
+    addAndMakeVisible(exportStatsButton);
+
     breakpointEditor.setMultiLine(true);
     breakpointEditor.setReturnKeyStartsNewLine(true);
     breakpointEditor.setReadOnly(false);
@@ -68,10 +143,22 @@ PanningEditor::PanningEditor(PanningProcessor& p) :
         processor.params, "law", lawCombo);
     syncAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         processor.params, "sync", syncButton);
-    curveGenAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        processor.params, "curvemode", curveGenCombo);
-
-    setSize(600, 700);
+    curveModeParameter = dynamic_cast<juce::AudioParameterChoice*>(processor.params.getParameter("curvemode"));
+    lastCurveMode = curveModeParameter->getIndex();
+    curveGenCombo.setSelectedId(lastCurveMode + 1, juce::dontSendNotification);
+    sidechainModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        processor.params, "scmode", sidechainModeCombo);
+    sidechainAmountAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        processor.params, "scamount", sidechainAmountSlider);
+    midiModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        processor.params, "midimode", midiModeCombo);
+    midiControllerAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        processor.params, "midicc", midiControllerSlider);
+    noteRetriggerAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        processor.params, "noteretrigger", noteRetriggerButton);
+
+    setWantsKeyboardFocus(true);
+    setSize(600, 740);
     startTimerHz(30);
 }
 
@@ -89,8 +176,11 @@ void PanningEditor::paint(juce::Graphics& g) {
     graphBounds = getLocalBounds().withTrimmedTop(40).withHeight(200).reduced(10, 0);
     drawGraphBackground(g, graphBounds);
     drawWaveform(g, graphBounds);
+    drawSelection(g, graphBounds);
     drawBreakpointMarkers(g, graphBounds);
     drawPanPosition(g, graphBounds, currentPanPosition);
+    if (statsButton.getToggleState())
+        drawStatsOverlay(g, graphBounds);
 
     g.setColour(juce::Colours::grey);
     g.setFont(12.0f);
@@ -124,18 +214,33 @@ void PanningEditor::drawGraphBackground(juce::Graphics& g, const juce::Rectangle
 }
 
 void PanningEditor::drawWaveform(juce::Graphics& g, const juce::Rectangle<int>& area) {
-    if (breakpointPath.empty()) return;
-
-    g.setColour(juce::Colours::cyan.withAlpha(0.8f));
-    juce::Path path;
-    bool first = true;
-
     float maxTime = 0.0f;
     for (const auto& point : breakpointPath) {
         maxTime = juce::jmax(maxTime, point.first);
     }
     if (maxTime <= 0.0f) maxTime = 1.0f;
 
+    // A pan expression overrides the points during playback, so it's drawn over them
+    auto expression = processor.getPanExpressionPreview(breakpointPath.empty() ? 10.0 : maxTime, area.getWidth());
+    if (!expression.empty()) {
+        if (breakpointPath.empty()) maxTime = 10.0f;
+        juce::Path expressionPath;
+        for (const auto& point : expression) {
+            float x = static_cast<float>(area.getX()) + static_cast<float>(point.first / maxTime) * static_cast<float>(area.getWidth());
+            float y = static_cast<float>(area.getY()) + static_cast<float>(area.getHeight()) * 0.5f * (1.0f - static_cast<float>(point.second));
+            if (expressionPath.isEmpty()) expressionPath.startNewSubPath(x, y);
+            else expressionPath.lineTo(x, y);
+        }
+        g.setColour(juce::Colours::orange.withAlpha(0.8f));
+        g.strokePath(expressionPath, juce::PathStrokeType(2.0f));
+    }
+
+    if (breakpointPath.empty()) return;
+
+    g.setColour(juce::Colours::cyan.withAlpha(expression.empty() ? 0.8f : 0.3f));
+    juce::Path path;
+    bool first = true;
+
     for (const auto& point : breakpointPath) {
         float x = static_cast<float>(area.getX()) + (point.first / maxTime) * static_cast<float>(area.getWidth());
         float y = static_cast<float>(area.getY()) + static_cast<float>(area.getHeight()) * 0.5f * (1.0f - point.second);
@@ -186,6 +291,60 @@ void PanningEditor::drawBreakpointMarkers(juce::Graphics& g, const juce::Rectang
     }
 }
 
+void PanningEditor::drawSelection(juce::Graphics& g, const juce::Rectangle<int>& area) {
+    if (selectionStart == selectionEnd) return;
+
+    float startX = timeValueToScreen(static_cast<float>(juce::jmin(selectionStart, selectionEnd)), 0.0f).x;
+    float endX = timeValueToScreen(static_cast<float>(juce::jmax(selectionStart, selectionEnd)), 0.0f).x;
+    startX = juce::jlimit(static_cast<float>(area.getX()), static_cast<float>(area.getRight()), startX);
+    endX = juce::jlimit(static_cast<float>(area.getX()), static_cast<float>(area.getRight()), endX);
+
+    g.setColour(juce::Colours::white.withAlpha(0.1f));
+    g.fillRect(startX, static_cast<float>(area.getY()), endX - startX, static_cast<float>(area.getHeight()));
+}
+
+void PanningEditor::drawStatsOverlay(juce::Graphics& g, const juce::Rectangle<int>& area) {
+    auto box = area.withSizeKeepingCentre(area.getWidth() - 20, area.getHeight() - 20)
+                   .removeFromRight(220).toFloat();
+    g.setColour(juce::Colours::black.withAlpha(0.75f));
+    g.fillRoundedRectangle(box, 4.0f);
+
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+    auto textArea = box.reduced(6.0f).toNearestInt();
+
+    if (!ProcessorStats::compiledIn) {
+        g.drawFittedText("Instrumentation is not compiled in.\nBuild with UBERPANNER_INSTRUMENTATION=1.",
+            textArea, juce::Justification::topLeft, 4);
+        return;
+    }
+
+    const auto stats = processor.getStats().getSnapshot();
+    juce::String text;
+    text << "blocks        " << stats.blocks << "\n";
+    text << "avg block     " << juce::String(stats.averageBlockMicros, 1) << " us\n";
+    text << "max block     " << juce::String(stats.maxBlockMicros, 1) << " us\n";
+    text << "seeks         " << stats.breakpointSeeks << "\n";
+    text << "table swaps   " << stats.tableSwaps << "\n";
+    text << "denormals in  " << stats.denormalInputs << "\n";
+    text << "smoothing     " << (stats.isSmoothing ? "yes " : "no ") << juce::String(stats.smoothedPan, 2) << "\n";
+    text << "prefetched    " << processor.getNumPrefetchedBlocks() << "\n";
+    g.drawFittedText(text, textArea.removeFromTop(textArea.getHeight() - 40), juce::Justification::topLeft, 8);
+
+    // Block time histogram, one bar per power-of-two bucket
+    juce::int64 largest = 1;
+    for (auto count : stats.histogram)
+        largest = juce::jmax(largest, count);
+
+    const float barWidth = static_cast<float>(textArea.getWidth()) / ProcessorStats::numHistogramBuckets;
+    g.setColour(juce::Colours::orange);
+    for (int i = 0; i < ProcessorStats::numHistogramBuckets; ++i) {
+        float height = static_cast<float>(textArea.getHeight()) * static_cast<float>(stats.histogram[i]) / static_cast<float>(largest);
+        g.fillRect(static_cast<float>(textArea.getX()) + barWidth * i, static_cast<float>(textArea.getBottom()) - height,
+            barWidth - 1.0f, height);
+    }
+}
+
 void PanningEditor::drawPanPosition(juce::Graphics& g, const juce::Rectangle<int>& area, float pan) {
     float maxTime = 0.0f;
     for (const auto& point : breakpointPath) {
@@ -220,7 +379,14 @@ void PanningEditor::drawPanPosition(juce::Graphics& g, const juce::Rectangle<int
 
 void PanningEditor::resized() {
     auto area = getLocalBounds();
-    auto header = area.removeFromTop(40);
+    auto header = area.removeFromTop(40).reduced(10, 8);
+    exportStatsButton.setBounds(header.removeFromRight(90));
+    header.removeFromRight(5);
+    statsButton.setBounds(header.removeFromRight(70));
+    header.removeFromRight(5);
+    lookaheadButton.setBounds(header.removeFromRight(100));
+    header.removeFromRight(5);
+    recordButton.setBounds(header.removeFromRight(80));
 
     graphBounds = area.removeFromTop(200).reduced(10, 10);
 
@@ -241,6 +407,31 @@ void PanningEditor::resized() {
     saveButton.setBounds(controlRow2.removeFromLeft(60));
     controlRow2.removeFromLeft(5);
     applyButton.setBounds(controlRow2.removeFromLeft(60));
+    controlRow2.removeFromLeft(10);
+    undoButton.setBounds(controlRow2.removeFromLeft(60));
+    controlRow2.removeFromLeft(5);
+    redoButton.setBounds(controlRow2.removeFromLeft(60));
+
+    auto controlRow3 = area.removeFromTop(40).reduced(10, 5);
+    bulkOpCombo.setBounds(controlRow3.removeFromLeft(160));
+    controlRow3.removeFromLeft(10);
+    bulkAmountSlider.setBounds(controlRow3.removeFromLeft(250));
+    controlRow3.removeFromLeft(10);
+    bulkApplyButton.setBounds(controlRow3.removeFromLeft(130));
+
+    auto controlRow4 = area.removeFromTop(40).reduced(10, 5);
+    sidechainModeCombo.setBounds(controlRow4.removeFromLeft(160));
+    controlRow4.removeFromLeft(10);
+    sidechainAmountSlider.setBounds(controlRow4.removeFromLeft(250));
+    controlRow4.removeFromLeft(10);
+    newSeedButton.setBounds(controlRow4.removeFromLeft(130));
+
+    auto controlRow5 = area.removeFromTop(40).reduced(10, 5);
+    midiModeCombo.setBounds(controlRow5.removeFromLeft(160));
+    controlRow5.removeFromLeft(10);
+    midiControllerSlider.setBounds(controlRow5.removeFromLeft(250));
+    controlRow5.removeFromLeft(10);
+    noteRetriggerButton.setBounds(controlRow5.removeFromLeft(130));
 
     auto statusRow = area.removeFromTop(30).reduced(10, 5);
     infoLabel.setBounds(statusRow.removeFromLeft(250));
@@ -252,15 +443,33 @@ void PanningEditor::resized() {
     breakpointEditor.setBounds(area.reduced(10, 10));
 }
 
+void PanningEditor::syncCurveGenCombo() {
+    // Host automation of "curvemode" selects and generates, as an attached combo would
+    const int mode = curveModeParameter->getIndex();
+    if (mode == lastCurveMode) return;
+    lastCurveMode = mode;
+    curveGenCombo.setSelectedId(mode + 1, juce::sendNotificationSync);
+}
+
 void PanningEditor::timerCallback() {
     currentPanPosition = static_cast<float>(panSlider.getValue());
+    syncCurveGenCombo();
+    undoButton.setEnabled(processor.getUndoManager().canUndo());
+    redoButton.setEnabled(processor.getUndoManager().canRedo());
+
+    // Picks up edits finished in the background as well as undo/redo
+    if (processor.getCurveRevision() != lastCurveRevision) {
+        lastCurveRevision = processor.getCurveRevision();
+        updateEditorText();
+    }
+    bulkApplyButton.setEnabled(!processor.isCurveOperationPending());
     updateBreakpointDisplay();
     repaint();
 }
 
 bool PanningEditor::isInterestedInFileDrag(const juce::StringArray& files) {
     for (const auto& file : files) {
-        if (file.endsWithIgnoreCase(".txt") || file.endsWithIgnoreCase(".brk") || file.endsWithIgnoreCase(".pan")) {
+        if (file.endsWithIgnoreCase(".txt") || file.endsWithIgnoreCase(".brk") || file.endsWithIgnoreCase(".pan") || file.endsWithIgnoreCase(".csv")) {
             return true;
         }
     }
@@ -269,7 +478,7 @@ bool PanningEditor::isInterestedInFileDrag(const juce::StringArray& files) {
 
 void PanningEditor::filesDropped(const juce::StringArray& files, int, int) {
     for (const auto& file : files) {
-        if (file.endsWithIgnoreCase(".txt") || file.endsWithIgnoreCase(".brk") || file.endsWithIgnoreCase(".pan")) {
+        if (file.endsWithIgnoreCase(".txt") || file.endsWithIgnoreCase(".brk") || file.endsWithIgnoreCase(".pan") || file.endsWithIgnoreCase(".csv")) {
             processor.loadBreakpointFile(juce::File(file));
             updateEditorText();
             updateBreakpointDisplay();
@@ -281,8 +490,22 @@ void PanningEditor::filesDropped(const juce::StringArray& files, int, int) {
 
 void PanningEditor::comboBoxChanged(juce::ComboBox* comboBoxThatHasChanged) {
     if (comboBoxThatHasChanged == &curveGenCombo) {
+        const int id = curveGenCombo.getSelectedId();
+        if (id != smoothNoiseId && id - 1 != curveModeParameter->getIndex()) {
+            lastCurveMode = id - 1;
+            curveModeParameter->beginChangeGesture();
+            *curveModeParameter = lastCurveMode;
+            curveModeParameter->endChangeGesture();
+        }
         generateCurve();
     }
+    else if (comboBoxThatHasChanged == &bulkOpCombo) {
+        // Sensible starting amount: factor, offset, factor, unused, grid, tolerance, crossfade
+        const double defaults[] = { 2.0, 0.5, 0.5, 0.0, 0.125, 0.01, 0.5 };
+        int index = juce::jlimit(1, 7, bulkOpCombo.getSelectedId()) - 1;
+        bulkAmountSlider.setValue(defaults[index], juce::dontSendNotification);
+        bulkAmountSlider.setEnabled(index != 3);
+    }
 }
 
 void PanningEditor::buttonClicked(juce::Button* button) {
@@ -298,6 +521,34 @@ void PanningEditor::buttonClicked(juce::Button* button) {
     else if (button == &generateButton) {
         generateCurve();
     }
+    else if (button == &newSeedButton) {
+        processor.reseedNoise();
+        statusLabel.setText("New noise seed; Generate to use it", juce::dontSendNotification);
+    }
+    else if (button == &undoButton) {
+        undoCurveEdit();
+    }
+    else if (button == &redoButton) {
+        redoCurveEdit();
+    }
+    else if (button == &bulkApplyButton) {
+        applyBulkOperation();
+    }
+    else if (button == &recordButton) {
+        if (!processor.setRecording(recordButton.getToggleState())) {
+            recordButton.setToggleState(false, juce::dontSendNotification);
+            statusLabel.setText("Can't record over a pan expression; remove the \"pan =\" line first", juce::dontSendNotification);
+        }
+    }
+    else if (button == &lookaheadButton) {
+        processor.setLookaheadRendering(lookaheadButton.getToggleState());
+    }
+    else if (button == &statsButton) {
+        processor.getStats().setEnabled(statsButton.getToggleState());
+    }
+    else if (button == &exportStatsButton) {
+        exportStats();
+    }
 }
 
 int PanningEditor::findBreakpointAtPosition(juce::Point<float> position, float tolerance) {
@@ -351,7 +602,8 @@ std::pair<float, float> PanningEditor::screenToTimeValue(juce::Point<float> scre
 void PanningEditor::updateBreakpointFromDrag(juce::Point<float> currentPosition) {
     if (draggedBreakpoint.index >= 0 && draggedBreakpoint.index < breakpointPath.size()) {
         auto [newTime, newValue] = screenToTimeValue(currentPosition);
-        processor.updateBreakpoint(draggedBreakpoint.index, newTime, newValue);
+        // The point may change place in the table when it's dragged past a neighbour
+        draggedBreakpoint.index = static_cast<int>(processor.updateBreakpoint(draggedBreakpoint.index, newTime, newValue));
         updateEditorText();
         updateBreakpointDisplay();
         repaint();
@@ -382,6 +634,11 @@ void PanningEditor::removeBreakpointAtPosition(juce::Point<float> position) {
 
 void PanningEditor::mouseDown(const juce::MouseEvent& event) {
     if (graphBounds.contains(event.getPosition())) {
+        if (event.mods.isLeftButtonDown() && event.mods.isShiftDown()) {
+            selectionStart = selectionEnd = screenToTimeValue(event.position).first;
+            isSelecting = true;
+            return;
+        }
         if (event.mods.isLeftButtonDown()) {
             int index = findBreakpointAtPosition(event.position);
             if (index >= 0) {
@@ -390,8 +647,10 @@ void PanningEditor::mouseDown(const juce::MouseEvent& event) {
                 draggedBreakpoint.originalTime = breakpointPath[index].first;
                 draggedBreakpoint.originalValue = breakpointPath[index].second;
                 isDragging = true;
+                processor.beginBreakpointDrag();
                 return;
             }
+            selectionStart = selectionEnd = 0.0;
         }
         else if (event.mods.isRightButtonDown()) {
             removeBreakpointAtPosition(event.position);
@@ -401,12 +660,23 @@ void PanningEditor::mouseDown(const juce::MouseEvent& event) {
 }
 
 void PanningEditor::mouseDrag(const juce::MouseEvent& event) {
+    if (isSelecting) {
+        selectionEnd = screenToTimeValue(event.position).first;
+        repaint();
+        return;
+    }
     if (isDragging && event.mods.isLeftButtonDown()) {
         updateBreakpointFromDrag(event.position);
     }
 }
 
 void PanningEditor::mouseUp(const juce::MouseEvent&) {
+    if (isSelecting) {
+        isSelecting = false;
+        if (selectionEnd < selectionStart) std::swap(selectionStart, selectionEnd);
+        statusLabel.setText("Selected " + juce::String(selectionStart, 2) + "s - " + juce::String(selectionEnd, 2) + "s",
+            juce::dontSendNotification);
+    }
     if (isDragging) {
         isDragging = false;
         statusLabel.setText("Breakpoint updated", juce::dontSendNotification);
@@ -419,6 +689,21 @@ void PanningEditor::mouseDoubleClick(const juce::MouseEvent& event) {
     }
 }
 
+bool PanningEditor::keyPressed(const juce::KeyPress& key) {
+    const auto command = juce::ModifierKeys::commandModifier;
+    const auto shift = juce::ModifierKeys::shiftModifier;
+
+    if (key == juce::KeyPress('z', command, 0)) {
+        undoCurveEdit();
+        return true;
+    }
+    if (key == juce::KeyPress('z', command | shift, 0) || key == juce::KeyPress('y', command, 0)) {
+        redoCurveEdit();
+        return true;
+    }
+    return false;
+}
+
 void PanningEditor::loadBreakpointFile() {
     fileChooser = std::make_unique<juce::FileChooser>(
         "Load Breakpoint File",
@@ -460,7 +745,10 @@ void PanningEditor::saveBreakpointFile() {
 void PanningEditor::applyBreakpoints() {
     processor.setBreakpointText(breakpointEditor.getText());
     updateBreakpointDisplay();
-    statusLabel.setText("Breakpoints applied", juce::dontSendNotification);
+    if (processor.getCurveErrors().isNotEmpty())
+        statusLabel.setText("Expression error: " + processor.getCurveErrors().upToFirstOccurrenceOf("\n", false, false), juce::dontSendNotification);
+    else
+        statusLabel.setText("Breakpoints applied", juce::dontSendNotification);
 }
 
 void PanningEditor::generateCurve() {
@@ -474,7 +762,10 @@ void PanningEditor::generateCurve() {
         processor.generateRampCurve(5.0f, -1.0f, 1.0f);
         break;
     case 4:
-        processor.generateRandomCurve(5.0f, 10.0f);
+    case 6:
+        // Uses the stored seed, so generating again gives the same curve until it's reseeded
+        processor.generateRandomCurve(5.0f, mode == 4 ? 10.0f : 2.0f,
+                                      mode == 4 ? NoiseGenerator::Shape::white : NoiseGenerator::Shape::gradient);
         break;
     case 5:
         processor.setBreakpointText(
@@ -511,4 +802,64 @@ void PanningEditor::updateBreakpointDisplay() {
 
 void PanningEditor::updateEditorText() {
     breakpointEditor.setText(processor.getBreakpointText());
+}
+
+void PanningEditor::undoCurveEdit() {
+    auto& undoManager = processor.getUndoManager();
+    if (undoManager.canUndo()) {
+        auto description = undoManager.getUndoDescription();
+        undoManager.undo();
+        updateEditorText();
+        updateBreakpointDisplay();
+        repaint();
+        statusLabel.setText("Undo: " + description, juce::dontSendNotification);
+    }
+}
+
+void PanningEditor::redoCurveEdit() {
+    auto& undoManager = processor.getUndoManager();
+    if (undoManager.canRedo()) {
+        auto description = undoManager.getRedoDescription();
+        undoManager.redo();
+        updateEditorText();
+        updateBreakpointDisplay();
+        repaint();
+        statusLabel.setText("Redo: " + description, juce::dontSendNotification);
+    }
+}
+
+void PanningEditor::applyBulkOperation() {
+    CurveOperation operation;
+    operation.type = static_cast<CurveOperation::Type>(juce::jlimit(1, 7, bulkOpCombo.getSelectedId()) - 1);
+    operation.amount = bulkAmountSlider.getValue();
+    if (operation.type == CurveOperation::Type::crossfade)
+        operation.other = processor.parseBreakpointText(breakpointEditor.getText()).pan;
+
+    processor.applyCurveOperation(operation, juce::jmin(selectionStart, selectionEnd), juce::jmax(selectionStart, selectionEnd));
+
+    if (processor.isCurveOperationPending())
+        statusLabel.setText("Processing: " + operation.getName() + "...", juce::dontSendNotification);
+    else
+        statusLabel.setText("Applied: " + operation.getName(), juce::dontSendNotification);
+    updateBreakpointDisplay();
+    repaint();
+}
+
+void PanningEditor::exportStats() {
+    fileChooser = std::make_unique<juce::FileChooser>(
+        "Export Stats",
+        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("panner_stats.json"),
+        "*.json;*.csv"
+    );
+
+    auto folderFlags = juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles;
+
+    fileChooser->launchAsync(folderFlags, [this](const juce::FileChooser& chooser) {
+        auto result = chooser.getResult();
+        if (result.getFullPathName().isNotEmpty()) {
+            const auto& stats = processor.getStats();
+            result.replaceWithText(result.hasFileExtension("csv") ? stats.toCSV() : stats.toJSON());
+            statusLabel.setText("Exported: " + result.getFileName(), juce::dontSendNotification);
+        }
+        });
 }
\ No newline at end of file
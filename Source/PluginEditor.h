@@ -19,6 +19,7 @@ public:
     void mouseDrag(const juce::MouseEvent& event) override;
     void mouseUp(const juce::MouseEvent& event) override;
     void mouseDoubleClick(const juce::MouseEvent& event) override;
+    bool keyPressed(const juce::KeyPress& key) override;
 
 private:
     PanningProcessor& processor;
@@ -32,6 +33,25 @@ private:
     juce::TextButton saveButton;
     juce::TextButton applyButton;
     juce::TextButton generateButton;
+    juce::TextButton newSeedButton;
+    juce::TextButton undoButton;
+    juce::TextButton redoButton;
+
+    juce::ComboBox bulkOpCombo;
+    juce::Slider bulkAmountSlider;
+    juce::TextButton bulkApplyButton;
+
+    juce::ComboBox sidechainModeCombo;
+    juce::Slider sidechainAmountSlider;
+
+    juce::ComboBox midiModeCombo;
+    juce::Slider midiControllerSlider;
+    juce::ToggleButton noteRetriggerButton;
+
+    juce::ToggleButton recordButton;
+    juce::ToggleButton lookaheadButton;
+    juce::ToggleButton statsButton;
+    juce::TextButton exportStatsButton;
 
     juce::TextEditor breakpointEditor;
     juce::Label editorLabel;
@@ -42,7 +62,11 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> panAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> lawAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> syncAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> curveGenAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> sidechainModeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> sidechainAmountAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> midiModeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> midiControllerAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> noteRetriggerAttachment;
 
     std::unique_ptr<juce::FileChooser> fileChooser;
 
@@ -61,6 +85,19 @@ private:
     DraggedBreakpoint draggedBreakpoint;
     bool isDragging = false;
 
+    // Time range selected with shift-drag; empty means the whole curve
+    double selectionStart = 0.0;
+    double selectionEnd = 0.0;
+    bool isSelecting = false;
+    int lastCurveRevision = -1;
+
+    // The generator combo follows the "curvemode" parameter by hand: Smooth Noise is an extra,
+    // editor-only entry, so the parameter's choices (and saved automation) keep their values
+    static constexpr int smoothNoiseId = 6;
+    juce::AudioParameterChoice* curveModeParameter = nullptr;
+    int lastCurveMode = -1;
+    void syncCurveGenCombo();
+
     void timerCallback() override;
     bool isInterestedInFileDrag(const juce::StringArray&) override;
     void filesDropped(const juce::StringArray& files, int, int) override;
@@ -81,11 +118,17 @@ private:
     void generateCurve();
     void updateBreakpointDisplay();
     void updateEditorText();
+    void undoCurveEdit();
+    void redoCurveEdit();
+    void applyBulkOperation();
+    void exportStats();
 
     void drawGraphBackground(juce::Graphics& g, const juce::Rectangle<int>& area);
     void drawWaveform(juce::Graphics& g, const juce::Rectangle<int>& area);
     void drawPanPosition(juce::Graphics& g, const juce::Rectangle<int>& area, float pan);
     void drawBreakpointMarkers(juce::Graphics& g, const juce::Rectangle<int>& area);
+    void drawSelection(juce::Graphics& g, const juce::Rectangle<int>& area);
+    void drawStatsOverlay(juce::Graphics& g, const juce::Rectangle<int>& area);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PanningEditor)
 };
\ No newline at end of file
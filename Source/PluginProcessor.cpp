@@ -1,11 +1,84 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+// One undoable curve edit. Both tables share every chunk the edit didn't touch,
+// so keeping a long history of edits on a huge curve stays cheap.
+class PanningProcessor::CurveEditAction : public juce::UndoableAction {
+public:
+    CurveEditAction(PanningProcessor& p, CurveData beforeEdit, CurveData afterEdit, bool isDragEdit, int units)
+        : processor(p), before(std::move(beforeEdit)), after(std::move(afterEdit)), isDrag(isDragEdit), sizeInUnits(units) {}
+
+    bool perform() override { processor.swapInCurve(after); return true; }
+    bool undo() override { processor.swapInCurve(before); return true; }
+    int getSizeInUnits() override { return sizeInUnits; }
+
+    juce::UndoableAction* createCoalescedAction(juce::UndoableAction* nextAction) override {
+        if (auto* next = dynamic_cast<CurveEditAction*>(nextAction)) {
+            if (isDrag && next->isDrag && &next->processor == &processor)
+                return new CurveEditAction(processor, before, next->after, true, sizeInUnits);
+        }
+        return nullptr;
+    }
+
+private:
+    PanningProcessor& processor;
+    CurveData before, after;
+    bool isDrag;
+    int sizeInUnits;
+};
+
+// Bulk edits too large for the message thread run here. One thread serves every instance, since
+// it's only busy while someone applies an operation to a very large selection.
+class PanningProcessor::CurveWorker : public juce::ThreadPool {
+public:
+    CurveWorker() : juce::ThreadPool(1) {}
+};
+
+// One bulk edit on a copy of the curve. The result is committed on the message thread, and
+// dropped if the instance has gone or its curve was edited meanwhile.
+class PanningProcessor::CurveOperationJob : public juce::ThreadPoolJob {
+public:
+    CurveOperationJob(PanningProcessor& processor, size_t start, size_t end, CurveOperation op, juce::String name)
+        : juce::ThreadPoolJob(name), owner(&processor), weakOwner(&processor), source(processor.breakpoints),
+          startIndex(start), endIndex(end), operation(std::move(op)), revision(processor.curveRevision.load()),
+          actionName(std::move(name)), pending(processor.pendingCurveOperations) {
+        ++*pending;
+    }
+
+    ~CurveOperationJob() override { --*pending; }
+
+    // Identifies the instance's jobs only; never dereferenced here
+    const PanningProcessor* getOwner() const noexcept { return owner; }
+
+    JobStatus runJob() override {
+        auto edited = CurveOperations::apply(source, startIndex, endIndex, operation);
+        if (shouldExit()) return jobHasFinished;
+
+        juce::MessageManager::callAsync([edited = std::move(edited), expectedRevision = revision, name = actionName, weakThis = weakOwner]() {
+            if (auto* processor = weakThis.get()) {
+                if (processor->curveRevision.load() == expectedRevision)
+                    processor->commitBreakpoints(edited, name);
+            }
+        });
+        return jobHasFinished;
+    }
+
+private:
+    const PanningProcessor* owner;
+    juce::WeakReference<PanningProcessor> weakOwner;
+    BreakpointTable source;
+    size_t startIndex, endIndex;
+    CurveOperation operation;
+    int revision;
+    juce::String actionName;
+    std::shared_ptr<std::atomic<int>> pending;
+};
+
 // FIX #1: Add explicit bus configuration to constructor
 PanningProcessor::PanningProcessor()
     : AudioProcessor(BusesProperties()
         .withInput("Input", juce::AudioChannelSet::stereo(), true)   // Accept stereo input
-        .withInput("Input", juce::AudioChannelSet::mono(), true)     // Accept mono input
+        .withInput("Sidechain", juce::AudioChannelSet::stereo(), false) // Optional pan modulation source
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)) // Output is stereo
     , params(*this, nullptr, "PARAMS", {
     std::make_unique<juce::AudioParameterFloat>(
@@ -36,6 +109,56 @@ PanningProcessor::PanningProcessor()
         juce::StringArray{"Manual", "Sine", "Ramp", "Random", "Bounce"},
         0,
         juce::AudioParameterChoiceAttributes()
+    ),
+    std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"scmode", 1},
+        "Sidechain Mode",
+        juce::StringArray{"Off", "Level", "Correlation"},
+        0,
+        juce::AudioParameterChoiceAttributes()
+    ),
+    std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"scamount", 1},
+        "Sidechain Amount",
+        juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f),
+        0.5f,
+        juce::AudioParameterFloatAttributes()
+            .withStringFromValueFunction([](float v, int) { return juce::String(v, 2); })
+            .withValueFromStringFunction([](const juce::String& t) { return t.getFloatValue(); })
+    ),
+    std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"scattack", 1},
+        "Sidechain Attack",
+        juce::NormalisableRange<float>(0.1f, 200.0f, 0.1f, 0.4f),
+        10.0f,
+        juce::AudioParameterFloatAttributes().withLabel("ms")
+    ),
+    std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"screlease", 1},
+        "Sidechain Release",
+        juce::NormalisableRange<float>(1.0f, 2000.0f, 1.0f, 0.4f),
+        200.0f,
+        juce::AudioParameterFloatAttributes().withLabel("ms")
+    ),
+    std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"midimode", 1},
+        "MIDI Pan",
+        juce::StringArray{"Off", "CC", "MPE Pitch Bend", "MPE Timbre"},
+        0,
+        juce::AudioParameterChoiceAttributes()
+    ),
+    std::make_unique<juce::AudioParameterInt>(
+        juce::ParameterID{"midicc", 1},
+        "MIDI Pan CC",
+        0, 127,
+        10,
+        juce::AudioParameterIntAttributes()
+    ),
+    std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"noteretrigger", 1},
+        "Note Retrigger",
+        false,
+        juce::AudioParameterBoolAttributes()
     )
         }) {
     juce::String defaultText =
@@ -47,80 +170,405 @@ PanningProcessor::PanningProcessor()
         "0.0 -1.0\n"
         "5.0 1.0\n";
     setBreakpointText(defaultText);
+    undoManager.clearUndoHistory();
 }
 
-PanningProcessor::~PanningProcessor() {}
+PanningProcessor::~PanningProcessor() {
+    gainPrefetcher.stop();
+
+    // The worker is shared, so only this instance's edits are cancelled
+    struct OwnJobs : juce::ThreadPool::JobSelector {
+        const PanningProcessor* owner;
+        explicit OwnJobs(const PanningProcessor* p) : owner(p) {}
+        bool isJobSuitable(juce::ThreadPoolJob* job) override {
+            auto* operationJob = dynamic_cast<CurveOperationJob*>(job);
+            return operationJob != nullptr && operationJob->getOwner() == owner;
+        }
+    } ownJobs(this);
+    curveWorker->removeAllJobs(true, 2000, &ownJobs);
+}
 
 bool PanningProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const {
     const auto& in = layouts.getMainInputChannelSet();
     const auto& out = layouts.getMainOutputChannelSet();
 
     // Only allow: mono→stereo or stereo→stereo
-    return (out == juce::AudioChannelSet::stereo()) &&
-        (in == juce::AudioChannelSet::mono() || in == juce::AudioChannelSet::stereo());
+    // Or up to ObjectLanes::maxSources mono objects→stereo
+    const bool mainSupported = (out == juce::AudioChannelSet::stereo()) &&
+        (in == juce::AudioChannelSet::mono() || in == juce::AudioChannelSet::stereo()
+            || (in.size() > 2 && in.size() <= ObjectLanes::maxSources));
+
+    // The sidechain is optional, mono or stereo
+    if (layouts.inputBuses.size() > 1) {
+        const auto& sidechain = layouts.getChannelSet(true, 1);
+        if (!sidechain.isDisabled() && sidechain != juce::AudioChannelSet::mono() && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
+    return mainSupported;
 }
 
-void PanningProcessor::prepareToPlay(double sampleRate, int /*samplesPerBlock*/) {
+void PanningProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     // FIX #2: Correct LinearSmoothedValue initialization
     smoothedPan.reset(sampleRate, 0.05); // Fixed: sampleRate, rampLengthInSeconds
     smoothedPan.setCurrentAndTargetValue(0.0f); // Also set initial value
     timeIncrement = 1.0 / sampleRate;
+    midiPan.reset(sampleRate, 0.005);
+    hasMidiPan = false;
+    midiPanChannel = 0;
+    retriggerTime = 0.0;
     currentBreakpointIndex = 0;
+    laneCursor = 0;
+    objectCursor = 0;
+    freeRunningTime = 0.0;
+    scratch.setSize(numScratchChannels, juce::jmax(32, samplesPerBlock));
+    sidechainFollower.prepare(sampleRate, scratch.getNumSamples());
+
+    // Real-time instances join the shared prefetch worker, which skips them while Lookahead is off
+    if (!isNonRealtime())
+        gainPrefetcher.start(sampleRate);
+    else
+        gainPrefetcher.stop();
+    gainPrefetcher.setEnabled(isLookaheadRendering());
+    preparedSampleRate = sampleRate;
+    panRecorder.setSampleRate(sampleRate);
+
+    // The prepared pan curve depends on the rate; curves already prepared at it are reused
+    if (preparedCurves == nullptr || !preparedCurves->isFor(breakpoints))
+        preparedCurves = std::make_shared<PreparedCurveSet>(breakpoints);
+    auto prepared = preparedCurves->get(sampleRate);
+    {
+        const juce::SpinLock::ScopedLockType lock(breakpointLock);
+        std::swap(preparedPan, prepared);
+        preparedCursor = {};
+    }
+
+    const int numSources = getMainBusNumInputChannels();
+    const size_t objectScratchSize = numSources > 2
+        ? (size_t)(scratch.getNumSamples() / objectControlInterval + 2) * (size_t)numSources : 0;
+    objectPans.assign(objectScratchSize, 0.0f);
+    objectLawMix.assign(objectScratchSize, 0.0f);
+    objectLeftGains.assign(objectScratchSize, 0.0f);
+    objectRightGains.assign(objectScratchSize, 0.0f);
+}
+
+void PanningProcessor::releaseResources() {
+    gainPrefetcher.stop();
+    preparedSampleRate = 0.0;
+}
+
+bool PanningProcessor::setRecording(bool shouldRecord) {
+    if (!shouldRecord) {
+        panRecorder.stop();
+        return true;
+    }
+    // A pan expression plays instead of the points, so the recorded points would never be heard
+    if (curveExpressions[CurveData::panExpression] != nullptr)
+        return false;
+    panRecorder.start(preparedSampleRate > 0.0 ? preparedSampleRate : getSampleRate());
+    return true;
 }
 
-void PanningProcessor::releaseResources() {}
+void PanningProcessor::mergeRecordedPass(const std::vector<Breakpoint>& points) {
+    // The take replaces whatever the curve had between its first and last point. Only the chunks
+    // around that range are rebuilt, and an expression loaded meanwhile is kept.
+    std::vector<Breakpoint> clamped;
+    clamped.reserve(points.size());
+    for (const auto& point : points)
+        clamped.push_back({ point.time, juce::jlimit(-1.0, 1.0, point.value) });
+
+    const auto first = breakpoints.lowerBound(clamped.front().time);
+    const auto last = breakpoints.upperBound(clamped.back().time);
+    commitBreakpoints(breakpoints.withReplaced(first, last, clamped), "Record Pan");
+}
+
+bool PanningProcessor::isLookaheadRendering() const {
+    return params.state.getProperty("lookahead", false);
+}
+
+void PanningProcessor::setLookaheadRendering(bool shouldPrefetch) {
+    params.state.setProperty("lookahead", shouldPrefetch, nullptr);
+    gainPrefetcher.setEnabled(shouldPrefetch);
+}
 
 PanningProcessor::PanGains PanningProcessor::linearPan(float position) const {
     position *= 0.5f;
     return { 0.5f - position, 0.5f + position };
 }
 
+namespace {
+    // sin and cos for |angle| <= pi/4 (pans within -1..1) from their Taylor series, which are
+    // within float rounding there. No calls or branches, so the block loops in renderPanGains
+    // vectorise across samples, or across sources and control points in object-bus mode.
+    inline void sinCosQuarterPi(float angle, float& sine, float& cosine) noexcept {
+        const float a2 = angle * angle;
+        sine = angle * (1.0f + a2 * (-1.0f / 6.0f + a2 * (1.0f / 120.0f + a2 * (-1.0f / 5040.0f + a2 * (1.0f / 362880.0f)))));
+        cosine = 1.0f + a2 * (-0.5f + a2 * (1.0f / 24.0f + a2 * (-1.0f / 720.0f + a2 * (1.0f / 40320.0f + a2 * (-1.0f / 3628800.0f)))));
+    }
+
+    inline void constantPowerGains(float position, float& left, float& right) noexcept {
+        constexpr float piOverFour = juce::MathConstants<float>::pi * 0.25f;
+        constexpr float sqrt2Over2 = juce::MathConstants<float>::sqrt2 * 0.5f;
+        float sinAngle, cosAngle;
+        sinCosQuarterPi(position * piOverFour, sinAngle, cosAngle);
+        left = sqrt2Over2 * (cosAngle - sinAngle);
+        right = sqrt2Over2 * (cosAngle + sinAngle);
+    }
+}
+
 PanningProcessor::PanGains PanningProcessor::constantPowerPan(float position) const {
-    constexpr float piOverFour = juce::MathConstants<float>::pi * 0.25f;
-    constexpr float sqrt2Over2 = juce::MathConstants<float>::sqrt2 * 0.5f;
-    float angle = position * piOverFour;
-    float sinAngle = std::sin(angle);
-    float cosAngle = std::cos(angle);
-    return { sqrt2Over2 * (cosAngle - sinAngle), sqrt2Over2 * (cosAngle + sinAngle) };
+    PanGains gains;
+    constantPowerGains(position, gains.left, gains.right);
+    return gains;
 }
 
 float PanningProcessor::getBreakpointValue(double time) {
+    // Caller must hold breakpointLock
     if (breakpoints.size() < 2) return 0.0f;
-    while (currentBreakpointIndex + 1 < breakpoints.size() && time > breakpoints[currentBreakpointIndex + 1].time) {
-        ++currentBreakpointIndex;
+
+    // Backward seeks (loops, random access) and far jumps ahead binary-search instead of scanning
+    bool searched = false;
+    const double value = breakpoints.getValueAt(time, currentBreakpointIndex, &searched);
+    if (searched) stats.recordBreakpointSeek();
+    return static_cast<float>(value);
+}
+
+namespace {
+    // Column indices below zero are fixed columns, objectColumn onwards are object-bus sources
+    // ("obj1" is objectColumn + 0) and the rest map to AutomationLanes::Lane
+    enum { ignoredColumn = -3, timeColumn = -2, panColumn = -1, objectColumn = 1000 };
+
+    int getColumnForName(const juce::String& name) {
+        auto lower = name.trim().toLowerCase();
+        if (lower == "time" || lower == "t") return timeColumn;
+        if (lower == "pan") return panColumn;
+        if (lower.startsWith("obj") && lower.getLastCharacters(1).containsOnly("0123456789")) {
+            const int source = lower.getTrailingIntValue();
+            if (source >= 1 && source <= ObjectLanes::maxSources) return objectColumn + source - 1;
+        }
+        for (int lane = 0; lane < AutomationLanes::numLanes; ++lane) {
+            if (lower == AutomationLanes::getLaneName(lane)) return lane;
+        }
+        return ignoredColumn;
+    }
+
+    // Whitespace or comma separated, so both the classic format and CSV load
+    juce::StringArray tokenise(const juce::String& line) {
+        auto tokens = juce::StringArray::fromTokens(line, ", \t;", "\"");
+        tokens.removeEmptyStrings();
+        return tokens;
     }
-    if (currentBreakpointIndex >= breakpoints.size() - 1) return static_cast<float>(breakpoints.back().value);
-    const auto& left = breakpoints[currentBreakpointIndex];
-    const auto& right = breakpoints[currentBreakpointIndex + 1];
-    if (right.time - left.time == 0.0) return static_cast<float>(right.value);
-    double fraction = (time - left.time) / (right.time - left.time);
-    return static_cast<float>(left.value + (right.value - left.value) * fraction);
 }
 
-void PanningProcessor::parseBreakpointText(const juce::String& text) {
-    breakpoints.clear();
+CurveData PanningProcessor::parseBreakpointText(const juce::String& text) const {
+    struct LaneRow { double time; float values[AutomationLanes::numLanes]; };
+    struct ObjectRow { double time; std::vector<float> values; };
+
+    // Without a header the columns are the classic "time pan"; anything after them is ignored, as it
+    // always was, so old files don't pick up gain, width or law from stray columns. Lanes need a header.
+    std::vector<int> columns{ timeColumn, panColumn };
+    std::vector<Breakpoint> points;
+    std::vector<LaneRow> laneRows;
+    std::array<bool, AutomationLanes::numLanes> lanesUsed{};
+    std::vector<ObjectRow> objectRows;
+    std::array<bool, ObjectLanes::maxSources> sourcesUsed{};
+    int numSources = 0;
+
     auto lines = juce::StringArray::fromLines(text);
     double lastTime = -1.0;
+    CurveData::Expressions expressions;
+    juce::StringArray errors;
+
+    // A header row ("time,pan,gain") or a "# columns: time gain width" comment remaps the columns below it
+    auto applyHeader = [&](const juce::StringArray& names) {
+        std::vector<int> mapped;
+        for (const auto& name : names)
+            mapped.push_back(getColumnForName(name));
+        if (std::find(mapped.begin(), mapped.end(), timeColumn) != mapped.end()) {
+            columns = mapped;
+            lastTime = -1.0;
+        }
+    };
 
     for (const auto& line : lines) {
         juce::String trimmed = line.trim();
-        if (trimmed.isEmpty() || trimmed.startsWithChar('#')) continue;
+        if (trimmed.isEmpty()) continue;
+        if (trimmed.startsWithChar('#')) {
+            auto comment = trimmed.substring(1).trim();
+            if (comment.startsWithIgnoreCase("columns:"))
+                applyHeader(tokenise(comment.fromFirstOccurrenceOf(":", false, false)));
+            continue;
+        }
 
-        auto tokens = juce::StringArray::fromTokens(trimmed, true);
-        if (tokens.size() >= 2) {
-            double time = tokens[0].getDoubleValue();
-            double value = juce::jlimit(-1.0, 1.0, tokens[1].getDoubleValue());
+        // "pan = 0.8*sin(tau*0.25*t)" drives its target from an expression instead of points
+        if (trimmed.containsChar('=')) {
+            const int column = getColumnForName(trimmed.upToFirstOccurrenceOf("=", false, false));
+            juce::String error;
+            if (column == panColumn || (column >= 0 && column < AutomationLanes::numLanes)) {
+                const auto source = trimmed.fromFirstOccurrenceOf("=", false, false);
+                if (auto expression = CurveExpression::compile(source, error))
+                    expressions[(size_t)(column == panColumn ? CurveData::panExpression : CurveData::laneExpressions + column)] = std::move(expression);
+            }
+            else if (column >= objectColumn) {
+                error = "Object lanes can't take an expression yet; use points";
+            }
+            else {
+                error = "Only pan, gain, width and law can take an expression";
+            }
+            if (error.isNotEmpty()) errors.add(trimmed + ": " + error);
+            continue;
+        }
+
+        auto tokens = tokenise(trimmed);
+        if (tokens.isEmpty()) continue;
+        if (!tokens[0].containsOnly("0123456789.-+eE")) {
+            applyHeader(tokens);
+            continue;
+        }
+
+        double time = 0.0;
+        bool hasTime = false, hasPan = false, hasLanes = false;
+        double pan = 0.0;
+        LaneRow row{};
+        std::fill(std::begin(row.values), std::end(row.values), std::numeric_limits<float>::quiet_NaN());
+        ObjectRow objectRow;
 
-            if (time >= lastTime) {
-                breakpoints.push_back({ time, value });
-                lastTime = time;
+        for (int i = 0; i < juce::jmin(tokens.size(), (int)columns.size()); ++i) {
+            const int column = columns[(size_t)i];
+            if (column == timeColumn) {
+                time = tokens[i].getDoubleValue();
+                hasTime = true;
+            }
+            else if (column == panColumn) {
+                pan = juce::jlimit(-1.0, 1.0, tokens[i].getDoubleValue());
+                hasPan = true;
+            }
+            else if (column >= objectColumn) {
+                const int source = column - objectColumn;
+                if ((int)objectRow.values.size() <= source)
+                    objectRow.values.resize((size_t)source + 1, std::numeric_limits<float>::quiet_NaN());
+                objectRow.values[(size_t)source] = tokens[i].getFloatValue();
+                sourcesUsed[(size_t)source] = true;
+                numSources = juce::jmax(numSources, source + 1);
+            }
+            else if (column >= 0) {
+                row.values[column] = tokens[i].getFloatValue();
+                lanesUsed[(size_t)column] = true;
+                hasLanes = true;
             }
         }
+
+        const bool hasObjects = !objectRow.values.empty();
+        if (hasTime && time >= lastTime && (hasPan || hasLanes || hasObjects)) {
+            if (hasPan) points.push_back({ time, pan });
+            if (hasLanes) {
+                row.time = time;
+                laneRows.push_back(row);
+            }
+            if (hasObjects) {
+                objectRow.time = time;
+                objectRows.push_back(std::move(objectRow));
+            }
+            lastTime = time;
+        }
     }
 
-    sortBreakpoints();
-    breakpointsLoaded = !breakpoints.empty();
-    currentBreakpointIndex = 0;
+    // Separate column blocks each restart their time order
+    std::stable_sort(points.begin(), points.end(),
+        [](const Breakpoint& a, const Breakpoint& b) { return a.time < b.time; });
+
+    CurveData curve{ BreakpointTable::fromSorted(points), nullptr, nullptr, std::move(expressions), errors.joinIntoString("\n") };
+    if (!laneRows.empty()) {
+        std::stable_sort(laneRows.begin(), laneRows.end(),
+            [](const LaneRow& a, const LaneRow& b) { return a.time < b.time; });
+
+        auto lanes = std::make_shared<AutomationLanes>();
+        for (int lane = 0; lane < AutomationLanes::numLanes; ++lane) {
+            if (lanesUsed[(size_t)lane]) lanes->setLanePresent(lane);
+        }
+        for (const auto& row : laneRows)
+            lanes->addRow(row.time, row.values);
+        curve.lanes = std::move(lanes);
+    }
+    if (!objectRows.empty()) {
+        std::stable_sort(objectRows.begin(), objectRows.end(),
+            [](const ObjectRow& a, const ObjectRow& b) { return a.time < b.time; });
+
+        auto objects = std::make_shared<ObjectLanes>(numSources);
+        for (int source = 0; source < numSources; ++source) {
+            if (sourcesUsed[(size_t)source]) objects->setSourcePresent(source);
+        }
+        std::vector<float> values;
+        for (auto& row : objectRows) {
+            values.assign((size_t)numSources, std::numeric_limits<float>::quiet_NaN());
+            std::copy(row.values.begin(), row.values.end(), values.begin());
+            objects->addRow(row.time, values.data());
+        }
+        curve.objects = std::move(objects);
+    }
+    // Created here so every instance sharing the cache entry shares its prepared curves too
+    attachPreparedCurves(curve);
+    return curve;
+}
+
+void PanningProcessor::commitBreakpoints(BreakpointTable newTable, const juce::String& actionName) {
+    auto curve = getCurveData();
+    curve.pan = std::move(newTable);
+    commitCurve(std::move(curve), actionName);
+}
+
+void PanningProcessor::commitGeneratedCurve(const std::vector<Breakpoint>& points, const juce::String& actionName) {
+    // A generated pan curve takes over from any pan expression
+    auto curve = getCurveData();
+    curve.pan = BreakpointTable::fromSorted(points);
+    curve.expressions[CurveData::panExpression] = nullptr;
+    commitCurve(std::move(curve), actionName);
+}
+
+void PanningProcessor::attachPreparedCurves(CurveData& curve) {
+    // Edits copy the CurveData they start from, so a set left over from the old table is replaced
+    if (curve.prepared == nullptr || !curve.prepared->isFor(curve.pan))
+        curve.prepared = std::make_shared<PreparedCurveSet>(curve.pan);
+}
+
+void PanningProcessor::commitCurve(CurveData newCurve, const juce::String& actionName) {
+    attachPreparedCurves(newCurve);
+    // An edit is charged for the chunks it doesn't share with the current curve: all of them for
+    // a replacement, the one or few it rebuilt for point and range edits
+    const int units = static_cast<int>(newCurve.pan.getNumChunks() - newCurve.pan.countChunksSharedWith(breakpoints)) + 1;
+    undoManager.beginNewTransaction(actionName);
+    undoManager.perform(new CurveEditAction(*this, getCurveData(), std::move(newCurve), false, units));
+}
+
+void PanningProcessor::swapInCurve(CurveData curve) {
+    // Undo states and other instances share their prepared curves; a new table only rebuilds
+    // the chunks that differ from the one playing now
+    attachPreparedCurves(curve);
+    std::shared_ptr<const PreparedCurve> prepared;
+    if (preparedSampleRate > 0.0)
+        prepared = curve.prepared->get(preparedSampleRate, preparedPan.get());
+
+    {
+        const juce::SpinLock::ScopedLockType lock(breakpointLock);
+        std::swap(breakpoints, curve.pan);
+        std::swap(preparedPan, prepared);
+        std::swap(automationLanes, curve.lanes);
+        std::swap(objectLanes, curve.objects);
+        std::swap(curveExpressions, curve.expressions);
+        breakpointsLoaded = !breakpoints.empty() || automationLanes != nullptr || objectLanes != nullptr
+            || std::any_of(curveExpressions.begin(), curveExpressions.end(), [](const auto& e) { return e != nullptr; });
+        currentBreakpointIndex = 0;
+        preparedCursor = {};
+        laneCursor = 0;
+        objectCursor = 0;
+    }
+    std::swap(curveErrors, curve.errors);
+    std::swap(curveCacheEntry, curve.cacheEntry);
+    std::swap(preparedCurves, curve.prepared);
+    ++curveRevision;
+    gainPrefetcher.setCurve(getCurveData(), curveRevision.load());
+    stats.recordTableSwap();
+    // 'curve' now holds the previous data and is released here (possibly freeing a shared
+    // cache entry), never on the audio thread
 }
 
 juce::String PanningProcessor::getBreakpointText() const {
@@ -130,22 +578,67 @@ juce::String PanningProcessor::getBreakpointText() const {
     text << "# Generated: " << juce::Time::getCurrentTime().toString(true, true) << "\n";
     text << "# Lines starting with '#' are ignored\n\n";
 
-    for (const auto& point : breakpoints) {
+    for (int slot = 0; slot < CurveData::numExpressions; ++slot) {
+        if (const auto& expression = curveExpressions[(size_t)slot]) {
+            text << (slot == CurveData::panExpression ? "pan" : AutomationLanes::getLaneName(slot - CurveData::laneExpressions))
+                 << " = " << expression->getSource() << "\n";
+        }
+    }
+
+    breakpoints.forEach([&text](const Breakpoint& point) {
         text << juce::String(point.time, 3) << " " << juce::String(point.value, 3) << "\n";
+    });
+
+    if (automationLanes != nullptr) {
+        const auto& lanes = *automationLanes;
+        text << "\n# columns: time";
+        for (int lane = 0; lane < AutomationLanes::numLanes; ++lane) {
+            if (lanes.hasLane(lane)) text << " " << AutomationLanes::getLaneName(lane);
+        }
+        text << "\n";
+
+        for (size_t row = 0; row < lanes.size(); ++row) {
+            text << juce::String(lanes.getTime(row), 3);
+            for (int lane = 0; lane < AutomationLanes::numLanes; ++lane) {
+                if (lanes.hasLane(lane)) text << " " << juce::String(lanes.getValue(lane, row), 3);
+            }
+            text << "\n";
+        }
+    }
+
+    if (objectLanes != nullptr) {
+        const auto& objects = *objectLanes;
+        text << "\n# columns: time";
+        for (int source = 0; source < objects.getNumSources(); ++source) {
+            if (objects.hasSource(source)) text << " obj" << (source + 1);
+        }
+        text << "\n";
+
+        for (size_t row = 0; row < objects.size(); ++row) {
+            text << juce::String(objects.getTime(row), 3);
+            for (int source = 0; source < objects.getNumSources(); ++source) {
+                if (objects.hasSource(source)) text << " " << juce::String(objects.getValue(source, row), 3);
+            }
+            text << "\n";
+        }
     }
     return text;
 }
 
 void PanningProcessor::setBreakpointText(const juce::String& text) {
-    parseBreakpointText(text);
+    // Instances given the same text share one parsed copy
+    commitCurve(curveCache->getOrParse(CurveCache::keyForText(text), [&] { return parseBreakpointText(text); }),
+                "Edit Breakpoints");
 }
 
 void PanningProcessor::loadBreakpointFile(const juce::File& file) {
-    juce::FileInputStream stream(file);
-    if (stream.openedOk()) {
-        juce::String content = stream.readEntireStreamAsString();
-        setBreakpointText(content);
-    }
+    if (!file.existsAsFile()) return;
+
+    // An unchanged file already loaded by another instance is neither read nor parsed again
+    commitCurve(curveCache->getOrParse(CurveCache::keyForFile(file), [&] {
+        juce::FileInputStream stream(file);
+        return parseBreakpointText(stream.openedOk() ? stream.readEntireStreamAsString() : juce::String());
+    }), "Edit Breakpoints");
 }
 
 void PanningProcessor::saveBreakpointFile(const juce::File& file) {
@@ -156,77 +649,126 @@ void PanningProcessor::saveBreakpointFile(const juce::File& file) {
 }
 
 void PanningProcessor::generateSineCurve(float duration, float amplitude, float frequency) {
-    breakpoints.clear();
-    const int points = 32;
-    for (int i = 0; i <= points; ++i) {
-        float t = duration * (float)i / (float)points;
+    std::vector<Breakpoint> points;
+    const int numPoints = 32;
+    for (int i = 0; i <= numPoints; ++i) {
+        float t = duration * (float)i / (float)numPoints;
         float value = amplitude * std::sin(juce::MathConstants<float>::twoPi * frequency * t);
-        breakpoints.push_back({ t, juce::jlimit(-1.0f, 1.0f, value) });
+        points.push_back({ t, juce::jlimit(-1.0f, 1.0f, value) });
     }
-    sortBreakpoints();
-    breakpointsLoaded = true;
-    currentBreakpointIndex = 0;
+    commitGeneratedCurve(points, "Generate Sine Curve");
 }
 
 void PanningProcessor::generateRampCurve(float duration, float start, float end) {
-    breakpoints.clear();
-    breakpoints.push_back({ 0.0, start });
-    breakpoints.push_back({ duration, end });
-    breakpointsLoaded = true;
-    currentBreakpointIndex = 0;
+    std::vector<Breakpoint> points;
+    points.push_back({ 0.0, start });
+    points.push_back({ duration, end });
+    commitGeneratedCurve(points, "Generate Ramp Curve");
 }
 
-void PanningProcessor::generateRandomCurve(float duration, float density) {
-    breakpoints.clear();
-    breakpoints.push_back({ 0.0, 0.0 });
+void PanningProcessor::generateRandomCurve(float duration, float density, NoiseGenerator::Shape shape) {
+    // White noise gets one point per step; smooth shapes are sampled 8 times per lattice cell
+    const int pointsPerCell = shape == NoiseGenerator::Shape::white ? 1 : 8;
+    const int numPoints = juce::jmax(1, static_cast<int>(duration * density)) * pointsPerCell;
+    const auto seed = static_cast<juce::uint64>(getNoiseSeed());
 
-    int numPoints = static_cast<int>(duration * density);
-    for (int i = 1; i <= numPoints; ++i) {
-        float t = duration * (float)i / (float)numPoints;
-        float value = juce::Random::getSystemRandom().nextFloat() * 2.0f - 1.0f;
-        breakpoints.push_back({ t, value });
-    }
-    sortBreakpoints();
-    breakpointsLoaded = true;
-    currentBreakpointIndex = 0;
+    std::vector<float> values((size_t)numPoints);
+    if (shape == NoiseGenerator::Shape::white)
+        NoiseGenerator::generateWhite(seed, 0, values.data(), numPoints);
+    else
+        NoiseGenerator::generate(shape, seed, 1.0 / pointsPerCell, 1.0 / pointsPerCell, values.data(), numPoints);
+
+    std::vector<Breakpoint> points;
+    points.reserve((size_t)numPoints + 1);
+    points.push_back({ 0.0, 0.0 });
+    for (int i = 1; i <= numPoints; ++i)
+        points.push_back({ duration * (double)i / (double)numPoints, values[(size_t)i - 1] });
+    commitGeneratedCurve(points, "Generate Random Curve");
+    generatedNoise = { breakpoints, duration, density, shape };
+}
+
+juce::int64 PanningProcessor::getNoiseSeed() const {
+    return static_cast<juce::int64>(params.state.getProperty("noiseSeed", 0));
+}
+
+void PanningProcessor::setNoiseSeed(juce::int64 seed) {
+    params.state.setProperty("noiseSeed", seed, nullptr);
+}
+
+void PanningProcessor::reseedNoise() {
+    setNoiseSeed(juce::Random::getSystemRandom().nextInt64());
+}
+
+std::vector<std::pair<double, double>> PanningProcessor::getPanExpressionPreview(double duration, int numPoints) const {
+    std::vector<std::pair<double, double>> result;
+    const auto& expression = curveExpressions[CurveData::panExpression];
+    if (expression == nullptr || numPoints < 2) return result;
+
+    std::vector<float> values((size_t)numPoints);
+    std::vector<double> workspace(CurveExpression::workspaceSize);
+    const double increment = duration / (numPoints - 1);
+    expression->evaluate(0.0, increment, numPoints, values.data(), workspace.data());
+
+    result.reserve((size_t)numPoints);
+    for (int i = 0; i < numPoints; ++i)
+        result.push_back({ i * increment, juce::jlimit(-1.0f, 1.0f, values[(size_t)i]) });
+    return result;
 }
 
 std::vector<std::pair<double, double>> PanningProcessor::getBreakpointsForDisplay() const {
     std::vector<std::pair<double, double>> result;
-    for (const auto& point : breakpoints) {
+    result.reserve(breakpoints.size());
+    breakpoints.forEach([&result](const Breakpoint& point) {
         result.push_back({ point.time, point.value });
-    }
+    });
     return result;
 }
 
-void PanningProcessor::updateBreakpoint(size_t index, double time, double value) {
-    if (index < breakpoints.size()) {
-        breakpoints[index].time = juce::jmax(0.0, time);
-        breakpoints[index].value = juce::jlimit(-1.0, 1.0, value);
-        sortBreakpoints();
+size_t PanningProcessor::updateBreakpoint(size_t index, double time, double value) {
+    if (index >= breakpoints.size()) return index;
+
+    size_t newIndex = index;
+    auto edited = breakpoints.withMoved(index, { juce::jmax(0.0, time), juce::jlimit(-1.0, 1.0, value) }, &newIndex);
+    auto curve = getCurveData();
+    curve.pan = std::move(edited);
+    attachPreparedCurves(curve);
+    undoManager.perform(new CurveEditAction(*this, getCurveData(), std::move(curve), true, 1));
+    return newIndex;
+}
+
+void PanningProcessor::beginBreakpointDrag() {
+    undoManager.beginNewTransaction("Move Breakpoint");
+}
+
+void PanningProcessor::applyCurveOperation(CurveOperation operation, double startTime, double endTime) {
+    size_t startIndex = 0;
+    size_t endIndex = breakpoints.size();
+    if (startTime < endTime) {
+        startIndex = breakpoints.lowerBound(startTime);
+        endIndex = breakpoints.upperBound(endTime);
+    }
+    if (startIndex >= endIndex) return;
+
+    const auto actionName = operation.getName();
+    if (endIndex - startIndex < backgroundOperationThreshold) {
+        commitBreakpoints(CurveOperations::apply(breakpoints, startIndex, endIndex, operation), actionName);
+        return;
     }
+
+    curveWorker->addJob(new CurveOperationJob(*this, startIndex, endIndex, operation, actionName), true);
 }
 
 void PanningProcessor::addBreakpoint(double time, double value) {
-    breakpoints.push_back({ juce::jmax(0.0, time), juce::jlimit(-1.0, 1.0, value) });
-    sortBreakpoints();
-    breakpointsLoaded = true;
+    commitBreakpoints(breakpoints.withInserted({ juce::jmax(0.0, time), juce::jlimit(-1.0, 1.0, value) }), "Add Breakpoint");
 }
 
 void PanningProcessor::removeBreakpoint(size_t index) {
     if (index < breakpoints.size()) {
-        breakpoints.erase(breakpoints.begin() + index);
-        breakpointsLoaded = !breakpoints.empty();
-        currentBreakpointIndex = 0;
+        commitBreakpoints(breakpoints.withRemoved(index), "Remove Breakpoint");
     }
 }
 
-void PanningProcessor::sortBreakpoints() {
-    std::sort(breakpoints.begin(), breakpoints.end(),
-        [](const Breakpoint& a, const Breakpoint& b) { return a.time < b.time; });
-}
-
-void PanningProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) {
+void PanningProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
     // DEBUG: Uncomment to test audio path
     /*
     const int numSamples = buffer.getNumSamples();
@@ -245,113 +787,395 @@ void PanningProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::Midi
     juce::ScopedNoDenormals noDenormals;
     const int numSamples = buffer.getNumSamples();
     const int totalInputChannels = getTotalNumInputChannels();
+    const int mainInputChannels = getMainBusNumInputChannels();
     const int totalOutputChannels = getTotalNumOutputChannels();
 
     if (totalOutputChannels < 2) return;
 
-    bool useBreakpoints = breakpointsLoaded && params.getRawParameterValue("sync")->load() > 0.5f;
+    ProcessorStats::ScopedBlockTimer blockTimer(stats, numSamples);
+    stats.recordDenormals(buffer, totalInputChannels);
+
+    // MIDI can take over the Pan parameter and restart the curve on each note
+    const auto midiSource = static_cast<MidiPanSource>(static_cast<int>(params.getRawParameterValue("midimode")->load()));
+    const int midiController = static_cast<int>(params.getRawParameterValue("midicc")->load());
+    const bool noteRetrigger = params.getRawParameterValue("noteretrigger")->load() > 0.5f;
+    if (midiSource == MidiPanSource::off) hasMidiPan = false;
+    const bool useMidi = midiSource != MidiPanSource::off || noteRetrigger;
+
+    // While recording, the Pan parameter drives the output and is captured against the host position
+    const bool recording = panRecorder.isRecording();
+    bool useBreakpoints = !recording && breakpointsLoaded.load() && (noteRetrigger || params.getRawParameterValue("sync")->load() > 0.5f);
     bool isConstantPower = params.getRawParameterValue("law")->load() > 0.5f;
+    float targetPan = params.getRawParameterValue("pan")->load();
+
+    // Sidechain level or correlation is added on top of whichever pan source is active
+    const auto sidechainMode = static_cast<SidechainFollower::Mode>(static_cast<int>(params.getRawParameterValue("scmode")->load()));
+    const float sidechainAmount = params.getRawParameterValue("scamount")->load();
+    const auto sidechain = getBusCount(true) > 1 ? getBusBuffer(buffer, true, 1) : juce::AudioBuffer<float>();
+    const bool useSidechain = sidechainMode != SidechainFollower::Mode::off && sidechain.getNumChannels() > 0;
+    if (useSidechain)
+        sidechainFollower.setTimes(params.getRawParameterValue("scattack")->load(), params.getRawParameterValue("screlease")->load());
 
-    if (!useBreakpoints) {
-        float targetPan = params.getRawParameterValue("pan")->load();
+    double sampleTime = 0.0;
+    if (useBreakpoints && noteRetrigger) {
+        // The curve runs from the last note-on instead of the host position
+        sampleTime = retriggerTime;
+        currentTime.store(sampleTime, std::memory_order_relaxed);
+    }
+    else if (useBreakpoints) {
+        sampleTime = getBlockStartTime(numSamples);
+    }
+    else {
         smoothedPan.setTargetValue(targetPan);
+        stats.recordSmoothing(smoothedPan.isSmoothing(), smoothedPan.getCurrentValue());
+    }
 
-        if (totalInputChannels == 1 && totalOutputChannels >= 2) {
-            auto* input = buffer.getReadPointer(0);
-            auto* left = buffer.getWritePointer(0);
-            auto* right = buffer.getWritePointer(1);
-
-            for (int i = 0; i < numSamples; ++i) {
-                float currentPan = smoothedPan.getNextValue();
-                auto gains = isConstantPower ? constantPowerPan(currentPan) : linearPan(currentPan);
-                float sample = input[i];
-                left[i] = sample * gains.left;
-                right[i] = sample * gains.right;
-            }
+    if (recording) {
+        const double blockStart = getBlockStartTime(numSamples);
+        if (hostIsPlaying)
+            panRecorder.push(static_cast<juce::int64>(std::llround(blockStart / timeIncrement)), numSamples, targetPan);
+        else
+            panRecorder.endPass();
+    }
+
+    // The message thread only holds this lock to swap curves; if it's busy, hold the last values
+    const juce::SpinLock::ScopedTryLockType curveLock(breakpointLock);
+    const bool curveAvailable = useBreakpoints && curveLock.isLocked();
+    const AutomationLanes* lanes = curveAvailable ? automationLanes.get() : nullptr;
+    const CurveExpression* panExpression = curveAvailable ? curveExpressions[CurveData::panExpression].get() : nullptr;
+    const ObjectLanes* objects = curveAvailable ? objectLanes.get() : nullptr;
+    const PreparedCurve* prepared = curveAvailable ? preparedPan.get() : nullptr;
+    const bool objectMode = mainInputChannels > 2 && !objectPans.empty();
+
+    // In lookahead mode the worker has usually rendered the gains already, so the curve isn't touched
+    const bool usePrefetchedGains = useBreakpoints && !useSidechain && !objectMode && !noteRetrigger && gainPrefetcher.isActive();
 
-            for (int ch = 2; ch < totalOutputChannels; ++ch) {
-                buffer.clear(ch, 0, numSamples);
+    // Blocks are split at every MIDI event so pan changes and retriggers land on their sample
+    auto midiEvent = useMidi ? midiMessages.cbegin() : midiMessages.cend();
+    bool retriggered = false;
+    const auto midiEnd = midiMessages.cend();
+
+    const int maxChunkSize = scratch.getNumSamples();
+    int num = 0;
+    for (int offset = 0; offset < numSamples && mainInputChannels > 0; offset += num) {
+        // Note-ons first, so an MPE pitch bend or timbre sent at the same sample as its note follows that note
+        auto eventsEnd = midiEvent;
+        while (eventsEnd != midiEnd && (*eventsEnd).samplePosition <= offset)
+            ++eventsEnd;
+        for (auto event = midiEvent; event != eventsEnd; ++event) {
+            const auto message = (*event).getMessage();
+            if (message.isNoteOn() && handleMidiMessage(message, midiSource, midiController) && noteRetrigger) {
+                sampleTime = 0.0;
+                retriggered = true;
             }
         }
-        else if (totalInputChannels >= 2 && totalOutputChannels >= 2) {
-            auto* leftIn = buffer.getReadPointer(0);
-            auto* rightIn = buffer.getReadPointer(1);
-            auto* leftOut = buffer.getWritePointer(0);
-            auto* rightOut = buffer.getWritePointer(1);
-
-            for (int i = 0; i < numSamples; ++i) {
-                float currentPan = smoothedPan.getNextValue();
-                auto gains = isConstantPower ? constantPowerPan(currentPan) : linearPan(currentPan);
-                leftOut[i] = leftIn[i] * gains.left;
-                rightOut[i] = rightIn[i] * gains.right;
-            }
+        for (auto event = midiEvent; event != eventsEnd; ++event) {
+            const auto message = (*event).getMessage();
+            if (!message.isNoteOn())
+                handleMidiMessage(message, midiSource, midiController);
+        }
+        midiEvent = eventsEnd;
+        const int segmentEnd = midiEvent != midiEnd ? juce::jmin(numSamples, (*midiEvent).samplePosition) : numSamples;
+        num = juce::jmin(maxChunkSize, segmentEnd - offset);
+        auto* pan = scratch.getWritePointer(panScratch);
+        auto* leftGain = scratch.getWritePointer(leftGainScratch);
+        auto* rightGain = scratch.getWritePointer(rightGainScratch);
 
-            for (int ch = 2; ch < totalOutputChannels; ++ch) {
-                buffer.clear(ch, 0, numSamples);
+        if (usePrefetchedGains && gainPrefetcher.read(static_cast<juce::int64>(std::llround(sampleTime / timeIncrement)), num,
+                                                      curveRevision.load(), isConstantPower, leftGain, rightGain)) {
+            applyGains(buffer, offset, num, leftGain, rightGain, nullptr);
+            sampleTime += num * timeIncrement;
+            continue;
+        }
+
+        // Pan position for every sample of the chunk
+        if (!useBreakpoints) {
+            auto& source = hasMidiPan ? midiPan : smoothedPan;
+            for (int i = 0; i < num; ++i)
+                pan[i] = source.getNextValue();
+        }
+        else if (panExpression != nullptr) {
+            panExpression->evaluate(sampleTime, timeIncrement, num, pan, expressionWorkspace.data());
+            juce::FloatVectorOperations::clip(pan, pan, -1.0f, 1.0f, num);
+            heldBreakpointPan = pan[num - 1];
+        }
+        else if (prepared != nullptr && !prepared->empty()) {
+            if (prepared->render(static_cast<juce::int64>(std::llround(sampleTime / timeIncrement)), num, preparedCursor, pan))
+                stats.recordBreakpointSeek();
+            heldBreakpointPan = pan[num - 1];
+        }
+        else if (curveAvailable && !breakpoints.empty()) {
+            // Not prepared yet (no sample rate), or a single point
+            double time = sampleTime;
+            for (int i = 0; i < num; ++i) {
+                pan[i] = getBreakpointValue(time);
+                time += timeIncrement;
             }
+            heldBreakpointPan = pan[num - 1];
         }
-    }
-    else {
-        // FIX #3: Robust playhead time calculation with validation
-        double blockStartTime = 0.0;
-        if (auto* playhead = getPlayHead()) {
-            auto positionInfo = playhead->getPosition();
-            if (positionInfo.hasValue()) {
-                auto timeInSeconds = positionInfo->getTimeInSeconds();
-                blockStartTime = timeInSeconds.orFallback(0.0);
-
-                // Validate time is reasonable
-                if (!std::isfinite(blockStartTime) || blockStartTime < 0.0) {
-                    blockStartTime = currentTime.load(std::memory_order_relaxed);
+        else {
+            // A lane-only file leaves pan to the parameter
+            juce::FloatVectorOperations::fill(pan, curveAvailable ? targetPan : heldBreakpointPan, num);
+        }
+
+        if (useSidechain) {
+            auto* modulation = scratch.getWritePointer(sidechainScratch);
+            sidechainFollower.process(sidechainMode, sidechain.getReadPointer(0, offset),
+                                      sidechain.getNumChannels() > 1 ? sidechain.getReadPointer(1, offset) : nullptr,
+                                      modulation, num);
+            juce::FloatVectorOperations::addWithMultiply(pan, modulation, sidechainAmount, num);
+            juce::FloatVectorOperations::clip(pan, pan, -1.0f, 1.0f, num);
+        }
+
+        // Extra lanes share one cursor and lane expressions override them; while the curve is
+        // being swapped the last values are held
+        float* laneValues[AutomationLanes::numLanes] = {};
+        if (curveAvailable) {
+            if (lanes != nullptr) {
+                for (int lane = 0; lane < AutomationLanes::numLanes; ++lane) {
+                    if (lanes->hasLane(lane)) laneValues[lane] = scratch.getWritePointer(laneScratch + lane);
+                }
+                lanes->render(sampleTime, timeIncrement, num, laneCursor, laneValues);
+            }
+            for (int lane = 0; lane < AutomationLanes::numLanes; ++lane) {
+                if (auto* expression = curveExpressions[(size_t)(CurveData::laneExpressions + lane)].get()) {
+                    const auto range = AutomationLanes::getValueRange(lane);
+                    laneValues[lane] = scratch.getWritePointer(laneScratch + lane);
+                    expression->evaluate(sampleTime, timeIncrement, num, laneValues[lane], expressionWorkspace.data());
+                    juce::FloatVectorOperations::clip(laneValues[lane], laneValues[lane], range.getStart(), range.getEnd(), num);
                 }
+                heldLanesActive[(size_t)lane] = laneValues[lane] != nullptr;
+                if (laneValues[lane] != nullptr) heldLaneValues[(size_t)lane] = laneValues[lane][num - 1];
+            }
+        }
+        else if (useBreakpoints) {
+            for (int lane = 0; lane < AutomationLanes::numLanes; ++lane) {
+                if (!heldLanesActive[(size_t)lane]) continue;
+                laneValues[lane] = scratch.getWritePointer(laneScratch + lane);
+                juce::FloatVectorOperations::fill(laneValues[lane], heldLaneValues[(size_t)lane], num);
             }
         }
 
-        currentTime.store(blockStartTime, std::memory_order_relaxed);
+        if (objectMode) {
+            mixObjects(buffer, offset, num, pan, laneValues[AutomationLanes::gainLane], laneValues[AutomationLanes::lawLane],
+                       sampleTime, objects, useBreakpoints && !curveAvailable, isConstantPower);
+            sampleTime += num * timeIncrement;
+            continue;
+        }
+
+        renderPanGains(pan, laneValues[AutomationLanes::lawLane], leftGain, rightGain, num, isConstantPower);
+        if (auto* gain = laneValues[AutomationLanes::gainLane]) {
+            juce::FloatVectorOperations::multiply(leftGain, gain, num);
+            juce::FloatVectorOperations::multiply(rightGain, gain, num);
+        }
 
-        double sampleTime = blockStartTime;
+        applyGains(buffer, offset, num, leftGain, rightGain, laneValues[AutomationLanes::widthLane]);
+        sampleTime += num * timeIncrement;
+    }
 
-        if (totalInputChannels == 1 && totalOutputChannels >= 2) {
-            auto* input = buffer.getReadPointer(0);
-            auto* left = buffer.getWritePointer(0);
-            auto* right = buffer.getWritePointer(1);
+    // The retrigger clock only runs while the curve plays; a note while it doesn't restarts it from zero
+    if (noteRetrigger && useBreakpoints)
+        retriggerTime = sampleTime;
+    else if (retriggered)
+        retriggerTime = 0.0;
 
-            for (int i = 0; i < numSamples; ++i) {
-                float currentPan = getBreakpointValue(sampleTime);
-                auto gains = isConstantPower ? constantPowerPan(currentPan) : linearPan(currentPan);
-                float sample = input[i];
-                left[i] = sample * gains.left;
-                right[i] = sample * gains.right;
-                sampleTime += timeIncrement;
-            }
+    for (int ch = 2; ch < totalOutputChannels; ++ch) {
+        buffer.clear(ch, 0, numSamples);
+    }
+}
 
-            for (int ch = 2; ch < totalOutputChannels; ++ch) {
-                buffer.clear(ch, 0, numSamples);
-            }
+bool PanningProcessor::handleMidiMessage(const juce::MidiMessage& message, MidiPanSource source, int controller) {
+    // 7-bit values centre on 64, pitch bend on 8192
+    auto setPan = [this](float value) {
+        if (!hasMidiPan) midiPan.setCurrentAndTargetValue(smoothedPan.getCurrentValue());
+        midiPan.setTargetValue(juce::jlimit(-1.0f, 1.0f, value));
+        hasMidiPan = true;
+    };
+
+    if (message.isNoteOn()) {
+        // MPE: the newest note's channel steers the pan
+        midiPanChannel = message.getChannel();
+        return true;
+    }
+
+    switch (source) {
+        case MidiPanSource::controller:
+            if (message.isControllerOfType(controller))
+                setPan(static_cast<float>(message.getControllerValue() - 64) / 63.0f);
+            break;
+        case MidiPanSource::pitchBend:
+            if (message.isPitchWheel() && message.getChannel() == midiPanChannel)
+                setPan(static_cast<float>(message.getPitchWheelValue() - 8192) / 8191.0f);
+            break;
+        case MidiPanSource::timbre:
+            if (message.isControllerOfType(74) && message.getChannel() == midiPanChannel)
+                setPan(static_cast<float>(message.getControllerValue() - 64) / 63.0f);
+            break;
+        case MidiPanSource::off:
+            break;
+    }
+    return false;
+}
+
+void PanningProcessor::mixObjects(juce::AudioBuffer<float>& buffer, int offset, int numSamples, const float* pan, const float* gain,
+                                  const float* lawMix, double startTime, const ObjectLanes* objects, bool holdLanes, bool constantPower) {
+    const int numSources = getMainBusNumInputChannels();
+    const size_t stride = (size_t)numSources;
+    const int numPoints = (numSamples + objectControlInterval - 1) / objectControlInterval + 1;
+    jassert((size_t)numPoints * stride <= objectPans.size());
+
+    // Pan of every source at each control point; sources without a lane follow the main pan
+    if (objects != nullptr)
+        objects->render(startTime, objectControlInterval * timeIncrement, numPoints, objectCursor, objectPans.data(), numSources);
+
+    // While the curve is being swapped, sources that had a lane hold their last pan
+    for (int source = 0; source < numSources; ++source) {
+        const bool hasLane = objects != nullptr ? objects->hasSource(source) : holdLanes && heldObjectsActive[(size_t)source];
+        if (!holdLanes) heldObjectsActive[(size_t)source] = hasLane;
+
+        float* sourcePans = objectPans.data() + source;
+        for (int k = 0; k < numPoints; ++k) {
+            if (!hasLane)
+                sourcePans[(size_t)k * stride] = pan[juce::jmin(k * objectControlInterval, numSamples - 1)];
+            else if (objects == nullptr)
+                sourcePans[(size_t)k * stride] = heldObjectPans[(size_t)source];
         }
-        else if (totalInputChannels >= 2 && totalOutputChannels >= 2) {
-            auto* leftIn = buffer.getReadPointer(0);
-            auto* rightIn = buffer.getReadPointer(1);
-            auto* leftOut = buffer.getWritePointer(0);
-            auto* rightOut = buffer.getWritePointer(1);
-
-            for (int i = 0; i < numSamples; ++i) {
-                float currentPan = getBreakpointValue(sampleTime);
-                auto gains = isConstantPower ? constantPowerPan(currentPan) : linearPan(currentPan);
-                leftOut[i] = leftIn[i] * gains.left;
-                rightOut[i] = rightIn[i] * gains.right;
-                sampleTime += timeIncrement;
+        if (hasLane) heldObjectPans[(size_t)source] = sourcePans[(size_t)(numPoints - 1) * stride];
+    }
+
+    // The law lane, like the main pan, is sampled at each control point and shared by every source
+    if (lawMix != nullptr) {
+        for (int k = 0; k < numPoints; ++k)
+            std::fill_n(objectLawMix.data() + (size_t)k * stride, numSources, lawMix[juce::jmin(k * objectControlInterval, numSamples - 1)]);
+    }
+
+    // One batched pass computes every source's gains at every control point
+    renderPanGains(objectPans.data(), lawMix != nullptr ? objectLawMix.data() : nullptr, objectLeftGains.data(), objectRightGains.data(),
+                   numPoints * numSources, constantPower);
+
+    // Mixdown segment by segment, so the two accumulators stay in cache while each source's
+    // input is streamed through once with its gains ramped between control points
+    auto* mixLeft = scratch.getWritePointer(leftGainScratch);
+    auto* mixRight = scratch.getWritePointer(rightGainScratch);
+    juce::FloatVectorOperations::clear(mixLeft, numSamples);
+    juce::FloatVectorOperations::clear(mixRight, numSamples);
+
+    for (int k = 0; k + 1 < numPoints; ++k) {
+        const int start = k * objectControlInterval;
+        const int length = juce::jmin(objectControlInterval, numSamples - start);
+        const float* left0 = objectLeftGains.data() + (size_t)k * stride;
+        const float* right0 = objectRightGains.data() + (size_t)k * stride;
+
+        for (int source = 0; source < numSources; ++source) {
+            const float* input = buffer.getReadPointer(source, offset + start);
+            float leftGain = left0[source];
+            float rightGain = right0[source];
+            const float leftStep = (left0[source + numSources] - leftGain) / objectControlInterval;
+            const float rightStep = (right0[source + numSources] - rightGain) / objectControlInterval;
+
+            for (int i = 0; i < length; ++i) {
+                mixLeft[start + i] += input[i] * leftGain;
+                mixRight[start + i] += input[i] * rightGain;
+                leftGain += leftStep;
+                rightGain += rightStep;
             }
+        }
+    }
+
+    if (gain != nullptr) {
+        juce::FloatVectorOperations::multiply(mixLeft, gain, numSamples);
+        juce::FloatVectorOperations::multiply(mixRight, gain, numSamples);
+    }
+    buffer.copyFrom(0, offset, mixLeft, numSamples);
+    buffer.copyFrom(1, offset, mixRight, numSamples);
+}
+
+void PanningProcessor::applyGains(juce::AudioBuffer<float>& buffer, int offset, int numSamples,
+                                  const float* leftGain, const float* rightGain, const float* width) {
+    if (getMainBusNumInputChannels() == 1) {
+        auto* input = buffer.getReadPointer(0, offset);
+        juce::FloatVectorOperations::multiply(buffer.getWritePointer(1, offset), input, rightGain, numSamples);
+        juce::FloatVectorOperations::multiply(buffer.getWritePointer(0, offset), leftGain, numSamples);
+        return;
+    }
+
+    auto* left = buffer.getWritePointer(0, offset);
+    auto* right = buffer.getWritePointer(1, offset);
+
+    if (width != nullptr) {
+        // Mid/side width before the balance stage
+        for (int i = 0; i < numSamples; ++i) {
+            const float mid = 0.5f * (left[i] + right[i]);
+            const float side = 0.5f * (left[i] - right[i]) * width[i];
+            left[i] = mid + side;
+            right[i] = mid - side;
+        }
+    }
+
+    juce::FloatVectorOperations::multiply(left, leftGain, numSamples);
+    juce::FloatVectorOperations::multiply(right, rightGain, numSamples);
+}
+
+double PanningProcessor::getBlockStartTime(int numSamples) {
+    // FIX #3: Robust playhead time calculation with validation
+    // Without a playhead position (offline rendering) the curve runs on from the previous block
+    double blockStartTime = freeRunningTime;
+    if (auto* playhead = getPlayHead()) {
+        auto positionInfo = playhead->getPosition();
+        if (positionInfo.hasValue()) {
+            hostIsPlaying = positionInfo->getIsPlaying();
+            auto timeInSeconds = positionInfo->getTimeInSeconds();
+            blockStartTime = timeInSeconds.orFallback(freeRunningTime);
 
-            for (int ch = 2; ch < totalOutputChannels; ++ch) {
-                buffer.clear(ch, 0, numSamples);
+            // Validate time is reasonable
+            if (!std::isfinite(blockStartTime) || blockStartTime < 0.0) {
+                blockStartTime = currentTime.load(std::memory_order_relaxed);
             }
         }
     }
+
+    currentTime.store(blockStartTime, std::memory_order_relaxed);
+    freeRunningTime = blockStartTime + numSamples * timeIncrement;
+    return blockStartTime;
+}
+
+void PanningProcessor::renderPanGains(const float* pan, const float* lawMix, float* left, float* right,
+                                      int numSamples, bool constantPower) const {
+    // Plain loops over arrays with inlined polynomial gains, so they vectorise
+    if (lawMix != nullptr) {
+        // Law lane: 0 = linear, 1 = constant power, crossfaded per sample
+        for (int i = 0; i < numSamples; ++i) {
+            float powerLeft, powerRight;
+            constantPowerGains(pan[i], powerLeft, powerRight);
+            const float linearLeft = 0.5f - 0.5f * pan[i];
+            const float linearRight = 0.5f + 0.5f * pan[i];
+            left[i] = linearLeft + (powerLeft - linearLeft) * lawMix[i];
+            right[i] = linearRight + (powerRight - linearRight) * lawMix[i];
+        }
+    }
+    else if (constantPower) {
+        for (int i = 0; i < numSamples; ++i)
+            constantPowerGains(pan[i], left[i], right[i]);
+    }
+    else {
+        for (int i = 0; i < numSamples; ++i) {
+            left[i] = 0.5f - 0.5f * pan[i];
+            right[i] = 0.5f + 0.5f * pan[i];
+        }
+    }
 }
 
 void PanningProcessor::getStateInformation(juce::MemoryBlock& destData) {
     auto state = params.copyState();
+
+    // The curve itself isn't saved, but a generated noise curve that's still in use (not edited
+    // since) is fully described by its settings and the seed, so those are
+    if (!breakpoints.empty() && breakpoints.sharesStorageWith(generatedNoise.table)) {
+        state.setProperty("noiseShape", static_cast<int>(generatedNoise.shape), nullptr);
+        state.setProperty("noiseDuration", generatedNoise.duration, nullptr);
+        state.setProperty("noiseDensity", generatedNoise.density, nullptr);
+    }
+
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
     copyXmlToBinary(*xml, destData);
 }
@@ -359,7 +1183,22 @@ void PanningProcessor::getStateInformation(juce::MemoryBlock& destData) {
 void PanningProcessor::setStateInformation(const void* data, int sizeInBytes) {
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
     if (xmlState.get() != nullptr && xmlState->hasTagName(params.state.getType())) {
-        params.replaceState(juce::ValueTree::fromXml(*xmlState));
+        auto state = juce::ValueTree::fromXml(*xmlState);
+        const auto noiseShape = state.getProperty("noiseShape");
+        const float noiseDuration = state.getProperty("noiseDuration", 5.0f);
+        const float noiseDensity = state.getProperty("noiseDensity", 10.0f);
+        for (auto property : { "noiseShape", "noiseDuration", "noiseDensity" })
+            state.removeProperty(property, nullptr);
+
+        params.replaceState(state);
+        gainPrefetcher.setEnabled(isLookaheadRendering());
+
+        // Same seed and settings, same points
+        if (!noiseShape.isVoid()) {
+            const int shape = juce::jlimit(0, static_cast<int>(NoiseGenerator::Shape::gradient), static_cast<int>(noiseShape));
+            generateRandomCurve(noiseDuration, noiseDensity, static_cast<NoiseGenerator::Shape>(shape));
+            undoManager.clearUndoHistory();
+        }
     }
 }
 
@@ -1,9 +1,24 @@
 #pragma once
 #include <JuceHeader.h>
+#include "BreakpointTable.h"
+#include "CurveOperations.h"
+#include "ProcessorStats.h"
+#include "CurveData.h"
+#include "CurveCache.h"
+#include "SidechainFollower.h"
+#include "NoiseGenerator.h"
+#include "GainPrefetcher.h"
+#include "PreparedCurve.h"
+#include "PanRecorder.h"
 
 class PanningProcessor : public juce::AudioProcessor {
 public:
-    enum Parameters { idxPan, idxLaw, idxSync, idxCurveMode };
+    enum Parameters { idxPan, idxLaw, idxSync, idxCurveMode,
+                      idxSidechainMode, idxSidechainAmount, idxSidechainAttack, idxSidechainRelease,
+                      idxMidiMode, idxMidiController, idxNoteRetrigger };
+
+    // Values of the "midimode" parameter
+    enum class MidiPanSource { off, controller, pitchBend, timbre };
 
     PanningProcessor();
     ~PanningProcessor() override;
@@ -16,7 +31,7 @@ public:
     bool hasEditor() const override { return true; }
 
     const juce::String getName() const override { return "UberPanner"; }
-    bool acceptsMidi() const override { return false; }
+    bool acceptsMidi() const override { return true; }
     bool producesMidi() const override { return false; }
     double getTailLengthSeconds() const override { return 0.0; }
 
@@ -40,14 +55,34 @@ public:
     void setBreakpointText(const juce::String& text);
     void generateSineCurve(float duration = 5.0f, float amplitude = 1.0f, float frequency = 0.5f);
     void generateRampCurve(float duration = 5.0f, float start = -1.0f, float end = 1.0f);
-    void generateRandomCurve(float duration = 5.0f, float density = 10.0f);
+    void generateRandomCurve(float duration = 5.0f, float density = 10.0f,
+                             NoiseGenerator::Shape shape = NoiseGenerator::Shape::white);
+
+    // Seed for generated noise curves, kept in the plugin state. Generating again reuses it;
+    // only reseedNoise picks a new one. A saved noise curve is regenerated from it on load.
+    juce::int64 getNoiseSeed() const;
+    void setNoiseSeed(juce::int64 seed);
+    void reseedNoise();
+    CurveData parseBreakpointText(const juce::String& text) const;
+    bool hasAutomationLanes() const { return automationLanes != nullptr; }
+    const juce::String& getCurveErrors() const { return curveErrors; }
+    std::vector<std::pair<double, double>> getPanExpressionPreview(double duration, int numPoints) const;
 
     // Interactive editing
     std::vector<std::pair<double, double>> getBreakpointsForDisplay() const;
-    void updateBreakpoint(size_t index, double time, double value);
+    size_t updateBreakpoint(size_t index, double time, double value); // returns the point's new index
     void addBreakpoint(double time, double value);
     void removeBreakpoint(size_t index);
-    void sortBreakpoints();
+
+    // Undo history for curve edits; moves made between beginBreakpointDrag() calls collapse into one step
+    juce::UndoManager& getUndoManager() { return undoManager; }
+    void beginBreakpointDrag();
+
+    // Bulk edits over the points between two times, or the whole curve when startTime >= endTime.
+    // Large selections are processed on a worker thread and committed back on the message thread.
+    void applyCurveOperation(CurveOperation operation, double startTime, double endTime);
+    bool isCurveOperationPending() const { return pendingCurveOperations->load() > 0; }
+    int getCurveRevision() const { return curveRevision.load(); }
 
     // Public helper functions for editor
     struct PanGains { float left; float right; };
@@ -57,18 +92,111 @@ public:
     // Public access to current time for editor visualization
     double getCurrentTime() const { return currentTime.load(); }
 
+    // Lookahead mode: a worker renders gains ahead of the playhead so processBlock mostly just
+    // multiplies. Kept in the plugin state; takes effect while playing in real time.
+    bool isLookaheadRendering() const;
+    void setLookaheadRendering(bool shouldPrefetch);
+    juce::int64 getNumPrefetchedBlocks() const { return gainPrefetcher.getNumBlocksServed(); }
+
+    // Record mode: Pan parameter moves during playback are simplified into breakpoints and merged into
+    // the curve (one undoable step per pass), replacing the points in the time range each pass covered.
+    // Refused (returns false) while a pan expression is loaded, since it would play over the points.
+    bool isRecording() const { return panRecorder.isRecording(); }
+    bool setRecording(bool shouldRecord);
+
+    // Audio-thread counters; recording is compiled out unless UBERPANNER_INSTRUMENTATION is set
+    ProcessorStats& getStats() { return stats; }
+
+    // The pan curve's value at 'time' through the playback lookup, moving its cursor as playback
+    // does. For the Benchmarks and Verification tools; only call it while processBlock isn't running.
+    float getBreakpointValue(double time);
+
 private:
-    struct Breakpoint { double time; double value; };
-    std::vector<Breakpoint> breakpoints;
-    bool breakpointsLoaded = false;
+    class CurveEditAction;
+    class CurveOperationJob;
+    class CurveWorker;
+
+    // Written on the message thread only; the audio thread reads under a try-lock
+    BreakpointTable breakpoints;
+    std::shared_ptr<PreparedCurveSet> preparedCurves;
+    std::shared_ptr<const PreparedCurve> preparedPan; // 'breakpoints' at the prepared sample rate
+    std::shared_ptr<const AutomationLanes> automationLanes;
+    std::shared_ptr<const ObjectLanes> objectLanes;
+    CurveData::Expressions curveExpressions;
+    juce::String curveErrors;
+    std::shared_ptr<const void> curveCacheEntry;
+    juce::SharedResourcePointer<CurveCache> curveCache;
+    juce::SpinLock breakpointLock;
+    std::atomic<bool> breakpointsLoaded{ false };
+    float heldBreakpointPan = 0.0f;
+    std::array<float, AutomationLanes::numLanes> heldLaneValues{ 1.0f, 1.0f, 1.0f };
+    std::array<bool, AutomationLanes::numLanes> heldLanesActive{};
+    size_t laneCursor = 0;
+    juce::UndoManager undoManager;
+    std::atomic<int> curveRevision{ 0 };
+    juce::SharedResourcePointer<CurveWorker> curveWorker; // one thread for every instance's large edits
+    std::shared_ptr<std::atomic<int>> pendingCurveOperations = std::make_shared<std::atomic<int>>(0);
+    static constexpr size_t backgroundOperationThreshold = 1 << 16;
     std::atomic<double> currentTime{ 0.0 };
     double timeIncrement = 0.0;
+    double freeRunningTime = 0.0;
     size_t currentBreakpointIndex = 0;
-
-    float getBreakpointValue(double time);
-    void parseBreakpointText(const juce::String& text);
+    PreparedCurve::Cursor preparedCursor;
+
+    CurveData getCurveData() const { return { breakpoints, automationLanes, objectLanes, curveExpressions, curveErrors, curveCacheEntry, preparedCurves }; }
+    void commitBreakpoints(BreakpointTable newTable, const juce::String& actionName);
+    void commitGeneratedCurve(const std::vector<Breakpoint>& points, const juce::String& actionName);
+    void commitCurve(CurveData newCurve, const juce::String& actionName);
+    void swapInCurve(CurveData curve);
+
+    // The last noise curve generated, so the state can say how to rebuild it while it's still playing
+    struct GeneratedNoise { BreakpointTable table; float duration = 0.0f, density = 0.0f; NoiseGenerator::Shape shape{}; };
+    GeneratedNoise generatedNoise;
+    static void attachPreparedCurves(CurveData& curve);
+
+    // Per-block gain rendering; the scratch buffer is sized in prepareToPlay and blocks are split to fit
+    enum ScratchChannel { panScratch, leftGainScratch, rightGainScratch, sidechainScratch, laneScratch,
+                          numScratchChannels = laneScratch + AutomationLanes::numLanes };
+    juce::AudioBuffer<float> scratch{ numScratchChannels, 512 };
+    std::vector<double> expressionWorkspace = std::vector<double>(CurveExpression::workspaceSize);
+
+    // Object-bus mode: with more than two main inputs each channel is a mono source with its own
+    // pan lane. Pans and gains are evaluated for all sources at once every objectControlInterval
+    // samples, then each source is mixed in with ramped gains.
+    static constexpr int objectControlInterval = 32;
+    std::vector<float> objectPans, objectLawMix, objectLeftGains, objectRightGains; // control points x sources
+    std::array<float, ObjectLanes::maxSources> heldObjectPans{};
+    std::array<bool, ObjectLanes::maxSources> heldObjectsActive{};
+    size_t objectCursor = 0;
+
+    void mixObjects(juce::AudioBuffer<float>& buffer, int offset, int numSamples, const float* pan, const float* gain,
+                    const float* lawMix, double startTime, const ObjectLanes* objects, bool holdLanes, bool constantPower);
+
+    GainPrefetcher gainPrefetcher{ [this](const float* pan, const float* lawMix, float* left, float* right, int numSamples, bool constantPower) {
+                                       renderPanGains(pan, lawMix, left, right, numSamples, constantPower); },
+                                   *params.getRawParameterValue("law") };
+    double preparedSampleRate = 0.0;
+
+    PanRecorder panRecorder{ [this](std::vector<Breakpoint> points) { mergeRecordedPass(points); } };
+    bool hostIsPlaying = true;
+    void mergeRecordedPass(const std::vector<Breakpoint>& points);
+
+    double getBlockStartTime(int numSamples);
+    void applyGains(juce::AudioBuffer<float>& buffer, int offset, int numSamples,
+                    const float* leftGain, const float* rightGain, const float* width);
+    void renderPanGains(const float* pan, const float* lawMix, float* left, float* right, int numSamples, bool constantPower) const;
+
+    // MIDI pan replaces the Pan parameter once a value arrives; retriggered curves keep their own clock
+    bool handleMidiMessage(const juce::MidiMessage& message, MidiPanSource source, int controller); // true for a note-on
+    juce::LinearSmoothedValue<float> midiPan;
+    bool hasMidiPan = false;
+    int midiPanChannel = 0;
+    double retriggerTime = 0.0;
 
     juce::LinearSmoothedValue<float> smoothedPan;
+    SidechainFollower sidechainFollower;
+    ProcessorStats stats;
 
+    JUCE_DECLARE_WEAK_REFERENCEABLE(PanningProcessor)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PanningProcessor)
 };
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "PreparedCurve.h"
+
+PreparedCurve PreparedCurve::fromTable(const BreakpointTable& table, double sampleRate, const PreparedCurve* previous) {
+    PreparedCurve curve;
+    if (table.size() < 2 || sampleRate <= 0.0) return curve;
+
+    curve.source = table;
+    curve.sampleRate = sampleRate;
+    curve.firstValue = static_cast<float>(table[0].value);
+
+    // A chunk's segments depend on its own points and the point after it, so an edit leaves the
+    // chunks around it untouched apart from the one before, whose last segment leads into it
+    std::unordered_map<const BreakpointTable::Chunk*, size_t> previousChunks;
+    if (previous != nullptr && previous->sampleRate == sampleRate) {
+        for (size_t i = 0; i < previous->source.getNumChunks(); ++i)
+            previousChunks.emplace(previous->source.getChunk(i).get(), i);
+    }
+
+    auto samePoint = [](const Breakpoint* a, const Breakpoint* b) {
+        return a == nullptr ? b == nullptr : b != nullptr && a->time == b->time && a->value == b->value;
+    };
+
+    curve.chunks.reserve(table.getNumChunks());
+    for (size_t i = 0; i < table.getNumChunks(); ++i) {
+        const auto* next = curve.pointAfterChunk(i);
+        auto found = previousChunks.find(table.getChunk(i).get());
+        if (found != previousChunks.end() && samePoint(next, previous->pointAfterChunk(found->second)))
+            curve.chunks.push_back(previous->chunks[found->second]);
+        else
+            curve.chunks.push_back(prepareChunk(*table.getChunk(i), next, sampleRate));
+    }
+
+    for (const auto& chunk : curve.chunks) {
+        if (chunk->starts.empty()) continue;
+        curve.playable.push_back(chunk.get());
+        curve.playableStarts.push_back(chunk->starts.front());
+    }
+    return curve;
+}
+
+std::shared_ptr<const PreparedCurve::Chunk> PreparedCurve::prepareChunk(const BreakpointTable::Chunk& points, const Breakpoint* next,
+                                                                        double sampleRate) {
+    auto chunk = std::make_shared<Chunk>();
+    chunk->starts.reserve(points.size());
+    chunk->values.reserve(points.size());
+    chunk->slopes.reserve(points.size());
+
+    auto addSegment = [&chunk](juce::int64 start, double value, double slope) {
+        chunk->starts.push_back(start);
+        chunk->values.push_back(static_cast<float>(value));
+        chunk->slopes.push_back(static_cast<float>(slope));
+    };
+
+    // Segment i covers the samples after point i up to and including point i + 1, matching
+    // BreakpointTable::getValueAt. Points closer together than a sample leave no segment.
+    auto firstSampleAfter = [sampleRate](double time) { return static_cast<juce::int64>(std::floor(time * sampleRate)) + 1; };
+
+    for (size_t i = 0; i < points.size(); ++i) {
+        const auto& point = points[i];
+        const Breakpoint* following = i + 1 < points.size() ? &points[i + 1] : next;
+        const auto start = firstSampleAfter(point.time);
+
+        if (following == nullptr) {
+            addSegment(start, point.value, 0.0);
+        }
+        else if (firstSampleAfter(following->time) > start) {
+            const double slope = (following->value - point.value) / (following->time - point.time);
+            addSegment(start, point.value + slope * (static_cast<double>(start) / sampleRate - point.time), slope / sampleRate);
+        }
+    }
+    return chunk;
+}
+
+const Breakpoint* PreparedCurve::pointAfterChunk(size_t chunkIndex) const {
+    return chunkIndex + 1 < source.getNumChunks() ? &source.getChunk(chunkIndex + 1)->front() : nullptr;
+}
+
+bool PreparedCurve::step(Cursor& cursor) const {
+    if (cursor.segment + 1 < playable[cursor.chunk]->starts.size()) {
+        ++cursor.segment;
+        return true;
+    }
+    if (cursor.chunk + 1 < playable.size()) {
+        ++cursor.chunk;
+        cursor.segment = 0;
+        return true;
+    }
+    return false;
+}
+
+PreparedCurve::Cursor PreparedCurve::seek(juce::int64 sample) const {
+    Cursor cursor;
+    auto chunkIt = std::upper_bound(playableStarts.begin(), playableStarts.end(), sample);
+    cursor.chunk = chunkIt == playableStarts.begin() ? 0 : static_cast<size_t>(chunkIt - playableStarts.begin()) - 1;
+
+    const auto& starts = playable[cursor.chunk]->starts;
+    auto segmentIt = std::upper_bound(starts.begin(), starts.end(), sample);
+    cursor.segment = segmentIt == starts.begin() ? 0 : static_cast<size_t>(segmentIt - starts.begin()) - 1;
+    return cursor;
+}
+
+bool PreparedCurve::render(juce::int64 startSample, int numSamples, Cursor& cursor, float* output) const {
+    jassert(!playable.empty());
+
+    // Seeks binary-search; playback steps the cursor forward once per segment boundary
+    bool searched = false;
+    const bool valid = cursor.chunk < playable.size() && cursor.segment < playable[cursor.chunk]->starts.size();
+    Cursor ahead = cursor;
+    if (!valid
+        || ((cursor.chunk > 0 || cursor.segment > 0) && startSample < startOf(cursor))
+        || (step(ahead) && step(ahead) && startSample >= startOf(ahead))) {
+        cursor = seek(startSample);
+        searched = true;
+    }
+
+    for (int i = 0; i < numSamples;) {
+        const juce::int64 position = startSample + i;
+        for (Cursor next = cursor; step(next) && position >= startOf(next);)
+            cursor = next;
+
+        const auto& chunk = *playable[cursor.chunk];
+        const juce::int64 start = chunk.starts[cursor.segment];
+        if (position < start) {
+            const int run = static_cast<int>(juce::jmin<juce::int64>(numSamples - i, start - position));
+            juce::FloatVectorOperations::fill(output + i, firstValue, run);
+            i += run;
+            continue;
+        }
+
+        Cursor next = cursor;
+        const juce::int64 end = step(next) ? startOf(next) : position + numSamples;
+        const int run = static_cast<int>(juce::jmin<juce::int64>(numSamples - i, end - position));
+        // Each sample's offset into the segment is converted exactly once, so the values don't
+        // depend on how the caller splits its blocks (the lookahead worker renders 32 at a time)
+        const float value = chunk.values[cursor.segment];
+        const float slope = chunk.slopes[cursor.segment];
+        const juce::int64 offset = position - start;
+        for (int k = 0; k < run; ++k)
+            output[i + k] = value + slope * static_cast<float>(offset + k);
+        i += run;
+    }
+    return searched;
+}
+
+std::shared_ptr<const PreparedCurve> PreparedCurveSet::get(double sampleRate, const PreparedCurve* previous) {
+    const juce::ScopedLock sl(lock);
+    for (const auto& entry : curves) {
+        if (entry.first == sampleRate)
+            return entry.second;
+    }
+    auto curve = std::make_shared<const PreparedCurve>(PreparedCurve::fromTable(source, sampleRate, previous));
+    curves.emplace_back(sampleRate, curve);
+    return curve;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <JuceHeader.h>
+#include "BreakpointTable.h"
+
+// The pan table laid out for playback at one sample rate: each segment's first sample as a
+// 64-bit index, plus its value there and its slope per sample, in three contiguous arrays.
+// Rendering is a multiply-add per sample with no division, and comparisons are on exact
+// sample indices, so they don't drift however long the session runs. Built on the message
+// thread whenever the curve or the sample rate changes, then immutable.
+//
+// Segments are grouped like the table's chunks (one prepared chunk per table chunk, holding the
+// segments that start at its points), so after an edit only the chunks it touched are rebuilt.
+class PreparedCurve {
+public:
+    struct Cursor { size_t chunk = 0, segment = 0; };
+
+    // 'previous', if given, is this table's curve before an edit: prepared chunks whose points
+    // (and following point) didn't change are shared with it rather than rebuilt.
+    static PreparedCurve fromTable(const BreakpointTable& table, double sampleRate, const PreparedCurve* previous = nullptr);
+
+    bool empty() const noexcept { return playable.empty(); }
+
+    // Audio thread: writes the values at samples [startSample, startSample + numSamples). 'cursor'
+    // persists between calls like BreakpointTable's; returns true if it had to binary-search.
+    bool render(juce::int64 startSample, int numSamples, Cursor& cursor, float* output) const;
+
+private:
+    struct Chunk {
+        std::vector<juce::int64> starts; // first sample of each segment
+        std::vector<float> values;       // value at that sample
+        std::vector<float> slopes;       // change per sample; the curve's last segment holds
+    };
+
+    BreakpointTable source; // keeps the table's chunks alive, so their identities can be compared
+    double sampleRate = 0.0;
+    std::vector<std::shared_ptr<const Chunk>> chunks; // one per table chunk
+    std::vector<const Chunk*> playable;               // the chunks with at least one segment
+    std::vector<juce::int64> playableStarts;          // first sample of each of those
+    float firstValue = 0.0f;                          // held before the first segment
+
+    static std::shared_ptr<const Chunk> prepareChunk(const BreakpointTable::Chunk& points, const Breakpoint* next, double sampleRate);
+    const Breakpoint* pointAfterChunk(size_t chunkIndex) const;
+
+    juce::int64 startOf(const Cursor& cursor) const { return playable[cursor.chunk]->starts[cursor.segment]; }
+    bool step(Cursor& cursor) const;
+    Cursor seek(juce::int64 sample) const;
+};
+
+// The prepared forms of one pan table, one per sample rate. It travels with the CurveData holding
+// the table, so instances sharing a CurveCache entry, and undo states returning to a table,
+// prepare it only once. Safe to use from any non-audio thread.
+class PreparedCurveSet {
+public:
+    explicit PreparedCurveSet(BreakpointTable table) : source(std::move(table)) {}
+
+    bool isFor(const BreakpointTable& table) const { return source.sharesStorageWith(table); }
+
+    // The curve at 'sampleRate', prepared on first use; 'previous' is passed on to fromTable
+    std::shared_ptr<const PreparedCurve> get(double sampleRate, const PreparedCurve* previous = nullptr);
+
+private:
+    const BreakpointTable source;
+    juce::CriticalSection lock;
+    std::vector<std::pair<double, std::shared_ptr<const PreparedCurve>>> curves;
+};
@@ -0,0 +1,96 @@
+#include "ProcessorStats.h"
+
+namespace {
+    double ticksToMicros(juce::int64 ticks) {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+    }
+
+    const char* const histogramLabels[ProcessorStats::numHistogramBuckets] = {
+        "lt_1us", "1_2us", "2_4us", "4_8us", "8_16us", "16_32us", "32_64us",
+        "64_128us", "128_256us", "256_512us", "512_1024us", "ge_1024us"
+    };
+}
+
+void ProcessorStats::recordBlock(juce::int64 ticks, int numSamples) noexcept {
+    increment(blocks);
+    increment(samples, numSamples);
+    increment(totalTicks, ticks);
+    if (ticks > maxBlockTicks.load(std::memory_order_relaxed))
+        maxBlockTicks.store(ticks, std::memory_order_relaxed);
+
+    const auto micros = static_cast<juce::uint32>(juce::jmin(ticksToMicros(ticks), 1.0e9));
+    const int bucket = micros == 0 ? 0 : juce::jmin(numHistogramBuckets - 1, juce::findHighestSetBit(micros) + 1);
+    increment(histogram[bucket]);
+}
+
+void ProcessorStats::countDenormals(const juce::AudioBuffer<float>& buffer, int numChannels) noexcept {
+    juce::int64 count = 0;
+    for (int ch = 0; ch < juce::jmin(numChannels, buffer.getNumChannels()); ++ch) {
+        const auto* data = buffer.getReadPointer(ch);
+        for (int i = 0; i < buffer.getNumSamples(); ++i) {
+            juce::uint32 bits;
+            std::memcpy(&bits, data + i, sizeof(bits));
+            count += ((bits & 0x7f800000u) == 0 && (bits & 0x007fffffu) != 0) ? 1 : 0;
+        }
+    }
+    if (count > 0) increment(denormalInputs, count);
+}
+
+ProcessorStats::Snapshot ProcessorStats::getSnapshot() const {
+    Snapshot snapshot;
+    snapshot.blocks = blocks.load(std::memory_order_relaxed);
+    snapshot.samples = samples.load(std::memory_order_relaxed);
+    snapshot.maxBlockMicros = ticksToMicros(maxBlockTicks.load(std::memory_order_relaxed));
+    snapshot.averageBlockMicros = snapshot.blocks > 0
+        ? ticksToMicros(totalTicks.load(std::memory_order_relaxed)) / static_cast<double>(snapshot.blocks) : 0.0;
+    for (int i = 0; i < numHistogramBuckets; ++i)
+        snapshot.histogram[i] = histogram[i].load(std::memory_order_relaxed);
+    snapshot.breakpointSeeks = breakpointSeeks.load(std::memory_order_relaxed);
+    snapshot.tableSwaps = tableSwaps.load(std::memory_order_relaxed);
+    snapshot.denormalInputs = denormalInputs.load(std::memory_order_relaxed);
+    snapshot.smoothingBlocks = smoothingBlocks.load(std::memory_order_relaxed);
+    snapshot.isSmoothing = smoothingActive.load(std::memory_order_relaxed);
+    snapshot.smoothedPan = smoothedPan.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+juce::String ProcessorStats::toJSON() const {
+    const auto snapshot = getSnapshot();
+
+    juce::DynamicObject::Ptr histogramObject = new juce::DynamicObject();
+    for (int i = 0; i < numHistogramBuckets; ++i)
+        histogramObject->setProperty(histogramLabels[i], snapshot.histogram[i]);
+
+    juce::DynamicObject::Ptr object = new juce::DynamicObject();
+    object->setProperty("blocks", snapshot.blocks);
+    object->setProperty("samples", snapshot.samples);
+    object->setProperty("max_block_us", snapshot.maxBlockMicros);
+    object->setProperty("average_block_us", snapshot.averageBlockMicros);
+    object->setProperty("block_time_histogram", juce::var(histogramObject.get()));
+    object->setProperty("breakpoint_seeks", snapshot.breakpointSeeks);
+    object->setProperty("table_swaps", snapshot.tableSwaps);
+    object->setProperty("denormal_inputs", snapshot.denormalInputs);
+    object->setProperty("smoothing_blocks", snapshot.smoothingBlocks);
+    object->setProperty("is_smoothing", snapshot.isSmoothing);
+    object->setProperty("smoothed_pan", snapshot.smoothedPan);
+    return juce::JSON::toString(juce::var(object.get()));
+}
+
+juce::String ProcessorStats::toCSV() const {
+    const auto snapshot = getSnapshot();
+    juce::String csv;
+    csv << "counter,value\n";
+    csv << "blocks," << snapshot.blocks << "\n";
+    csv << "samples," << snapshot.samples << "\n";
+    csv << "max_block_us," << snapshot.maxBlockMicros << "\n";
+    csv << "average_block_us," << snapshot.averageBlockMicros << "\n";
+    for (int i = 0; i < numHistogramBuckets; ++i)
+        csv << "histogram_" << histogramLabels[i] << "," << snapshot.histogram[i] << "\n";
+    csv << "breakpoint_seeks," << snapshot.breakpointSeeks << "\n";
+    csv << "table_swaps," << snapshot.tableSwaps << "\n";
+    csv << "denormal_inputs," << snapshot.denormalInputs << "\n";
+    csv << "smoothing_blocks," << snapshot.smoothingBlocks << "\n";
+    csv << "is_smoothing," << (snapshot.isSmoothing ? 1 : 0) << "\n";
+    csv << "smoothed_pan," << snapshot.smoothedPan << "\n";
+    return csv;
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Build with UBERPANNER_INSTRUMENTATION=1 to compile the audio-thread counters in.
+// Without it every recording call below is an empty inline function.
+#ifndef UBERPANNER_INSTRUMENTATION
+ #define UBERPANNER_INSTRUMENTATION 0
+#endif
+
+// Lock-free per-instance counters written from processBlock with relaxed atomics and
+// read from the editor. The audio thread is the only writer of the block counters.
+class ProcessorStats {
+public:
+    static constexpr bool compiledIn = UBERPANNER_INSTRUMENTATION != 0;
+
+    // processBlock time buckets: < 1us, then powers of two up to >= 1024us
+    static constexpr int numHistogramBuckets = 12;
+
+    struct Snapshot {
+        juce::int64 blocks = 0;
+        juce::int64 samples = 0;
+        double maxBlockMicros = 0.0;
+        double averageBlockMicros = 0.0;
+        juce::int64 histogram[numHistogramBuckets] = {};
+        juce::int64 breakpointSeeks = 0;
+        juce::int64 tableSwaps = 0;
+        juce::int64 denormalInputs = 0;
+        juce::int64 smoothingBlocks = 0;
+        bool isSmoothing = false;
+        float smoothedPan = 0.0f;
+    };
+
+    class ScopedBlockTimer {
+    public:
+        ScopedBlockTimer(ProcessorStats& s, int numSamples) : stats(s) {
+            if constexpr (compiledIn) {
+                if (stats.isEnabled()) {
+                    startTicks = juce::Time::getHighResolutionTicks();
+                    blockSamples = numSamples;
+                }
+            }
+            else {
+                juce::ignoreUnused(numSamples);
+            }
+        }
+
+        ~ScopedBlockTimer() {
+            if constexpr (compiledIn) {
+                if (startTicks != 0)
+                    stats.recordBlock(juce::Time::getHighResolutionTicks() - startTicks, blockSamples);
+            }
+        }
+
+    private:
+        ProcessorStats& stats;
+        juce::int64 startTicks = 0;
+        int blockSamples = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlockTimer)
+    };
+
+    void setEnabled(bool shouldBeEnabled) { enabled.store(shouldBeEnabled, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept {
+        if constexpr (compiledIn) return enabled.load(std::memory_order_relaxed);
+        else return false;
+    }
+
+    void recordBreakpointSeek() noexcept {
+        if constexpr (compiledIn) {
+            if (isEnabled()) increment(breakpointSeeks);
+        }
+    }
+
+    void recordTableSwap() noexcept {
+        if constexpr (compiledIn) {
+            if (isEnabled()) increment(tableSwaps);
+        }
+    }
+
+    void recordSmoothing(bool isSmoothing, float currentPan) noexcept {
+        if constexpr (compiledIn) {
+            if (isEnabled()) {
+                smoothingActive.store(isSmoothing, std::memory_order_relaxed);
+                smoothedPan.store(currentPan, std::memory_order_relaxed);
+                if (isSmoothing) increment(smoothingBlocks);
+            }
+        }
+        else {
+            juce::ignoreUnused(isSmoothing, currentPan);
+        }
+    }
+
+    // Counts denormal input samples by bit pattern, since flush-to-zero hides them from comparisons
+    void recordDenormals(const juce::AudioBuffer<float>& buffer, int numChannels) noexcept {
+        if constexpr (compiledIn) {
+            if (isEnabled()) countDenormals(buffer, numChannels);
+        }
+        else {
+            juce::ignoreUnused(buffer, numChannels);
+        }
+    }
+
+    Snapshot getSnapshot() const;
+
+    juce::String toJSON() const;
+    juce::String toCSV() const;
+
+private:
+    std::atomic<bool> enabled{ false };
+    std::atomic<juce::int64> blocks{ 0 };
+    std::atomic<juce::int64> samples{ 0 };
+    std::atomic<juce::int64> totalTicks{ 0 };
+    std::atomic<juce::int64> maxBlockTicks{ 0 };
+    std::atomic<juce::int64> histogram[numHistogramBuckets] = {};
+    std::atomic<juce::int64> breakpointSeeks{ 0 };
+    std::atomic<juce::int64> tableSwaps{ 0 };
+    std::atomic<juce::int64> denormalInputs{ 0 };
+    std::atomic<juce::int64> smoothingBlocks{ 0 };
+    std::atomic<bool> smoothingActive{ false };
+    std::atomic<float> smoothedPan{ 0.0f };
+
+    static void increment(std::atomic<juce::int64>& counter, juce::int64 amount = 1) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    void recordBlock(juce::int64 ticks, int numSamples) noexcept;
+    void countDenormals(const juce::AudioBuffer<float>& buffer, int numChannels) noexcept;
+};
@@ -0,0 +1,72 @@
+#include "SidechainFollower.h"
+
+void SidechainFollower::prepare(double newSampleRate, int maxBlockSize) {
+    sampleRate = newSampleRate;
+    work.setSize(3, juce::jmax(32, maxBlockSize));
+    reset();
+}
+
+void SidechainFollower::reset() {
+    envelope = 0.0f;
+    leftPower = rightPower = crossPower = 0.0f;
+}
+
+float SidechainFollower::coefficientFor(float milliseconds) const {
+    return static_cast<float>(std::exp(-1000.0 / (juce::jmax(0.01f, milliseconds) * sampleRate)));
+}
+
+void SidechainFollower::setTimes(float attackMs, float releaseMs) {
+    attackCoefficient = coefficientFor(attackMs);
+    releaseCoefficient = coefficientFor(releaseMs);
+}
+
+void SidechainFollower::process(Mode mode, const float* left, const float* right, float* output, int numSamples) {
+    jassert(numSamples <= work.getNumSamples());
+
+    if (mode == Mode::off) {
+        juce::FloatVectorOperations::clear(output, numSamples);
+        return;
+    }
+
+    if (mode == Mode::correlation && right != nullptr) {
+        auto* leftSquared = work.getWritePointer(0);
+        auto* rightSquared = work.getWritePointer(1);
+        auto* cross = work.getWritePointer(2);
+        juce::FloatVectorOperations::multiply(leftSquared, left, left, numSamples);
+        juce::FloatVectorOperations::multiply(rightSquared, right, right, numSamples);
+        juce::FloatVectorOperations::multiply(cross, left, right, numSamples);
+
+        const float smoothing = releaseCoefficient;
+        for (int i = 0; i < numSamples; ++i) {
+            leftPower = leftSquared[i] + smoothing * (leftPower - leftSquared[i]);
+            rightPower = rightSquared[i] + smoothing * (rightPower - rightSquared[i]);
+            crossPower = cross[i] + smoothing * (crossPower - cross[i]);
+            const float energy = std::sqrt(leftPower * rightPower);
+            output[i] = energy > 1.0e-9f ? crossPower / energy : 0.0f;
+        }
+        juce::FloatVectorOperations::clip(output, output, -1.0f, 1.0f, numSamples);
+        return;
+    }
+
+    if (mode == Mode::correlation) {
+        juce::FloatVectorOperations::fill(output, 1.0f, numSamples); // a single channel is fully correlated
+        return;
+    }
+
+    // Level: rectified (mean of both channels), then attack/release
+    auto* rectified = work.getWritePointer(0);
+    juce::FloatVectorOperations::abs(rectified, left, numSamples);
+    if (right != nullptr) {
+        auto* rectifiedRight = work.getWritePointer(1);
+        juce::FloatVectorOperations::abs(rectifiedRight, right, numSamples);
+        juce::FloatVectorOperations::add(rectified, rectifiedRight, numSamples);
+        juce::FloatVectorOperations::multiply(rectified, 0.5f, numSamples);
+    }
+
+    for (int i = 0; i < numSamples; ++i) {
+        const float coefficient = rectified[i] > envelope ? attackCoefficient : releaseCoefficient;
+        envelope = rectified[i] + coefficient * (envelope - rectified[i]);
+        output[i] = envelope;
+    }
+    juce::FloatVectorOperations::clip(output, output, 0.0f, 1.0f, numSamples);
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Turns the sidechain input into a per-sample modulation signal for the pan position:
+// its level (an attack/release envelope, 0 to 1) or the correlation between its two
+// channels (-1 to 1, averaged over the release time). Rectification and the per-channel
+// products run as whole-block vector operations; only the one-pole smoothing is per sample.
+class SidechainFollower {
+public:
+    enum class Mode { off, level, correlation };
+
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+    void setTimes(float attackMs, float releaseMs);
+
+    // Writes numSamples modulation values; 'right' may be null for a mono sidechain,
+    // in which case correlation reads as 1. numSamples must not exceed maxBlockSize.
+    void process(Mode mode, const float* left, const float* right, float* output, int numSamples);
+
+private:
+    double sampleRate = 44100.0;
+    float attackCoefficient = 0.0f, releaseCoefficient = 0.0f;
+    float envelope = 0.0f;
+    float leftPower = 0.0f, rightPower = 0.0f, crossPower = 0.0f;
+    juce::AudioBuffer<float> work{ 3, 512 };
+
+    float coefficientFor(float milliseconds) const;
+};
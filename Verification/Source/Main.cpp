@@ -0,0 +1,648 @@
+#include <JuceHeader.h>
+#include <iostream>
+#include "../../Source/PluginProcessor.h"
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <pthread.h>
+#endif
+
+// Golden-output checks for the panner's fast paths. Deterministic signals are rendered through
+// processBlock for every input layout, pan law, sync mode and curve type (inline and with
+// lookahead rendering), plus sidechain modulation, MIDI control and note retrigger, and compared
+// sample by sample with a plain double-precision reference written from the documented
+// behaviour. While processBlock runs, the audio thread must not allocate or free memory or lock
+// a mutex. Locks can only be counted on Linux; elsewhere the cases say they weren't checked.
+//
+// Usage: Verification [--quick] [--verbose]
+// Exits with 1 if any case fails.
+
+//==============================================================================
+// Real-time checker: counts heap and mutex traffic on a thread while it is marked as the audio thread
+namespace {
+    thread_local bool isCheckingRealtime = false;
+    std::atomic<int> realtimeAllocations{ 0 };
+    std::atomic<int> realtimeLocks{ 0 };
+
+    struct ScopedRealtimeCheck {
+        ScopedRealtimeCheck() { isCheckingRealtime = true; }
+        ~ScopedRealtimeCheck() { isCheckingRealtime = false; }
+    };
+
+    // Locks are counted by interposing pthread_mutex_lock, which only works on Linux
+   #if JUCE_LINUX
+    constexpr bool canCountLocks = true;
+   #else
+    constexpr bool canCountLocks = false;
+   #endif
+}
+
+void* operator new(std::size_t size) {
+    if (isCheckingRealtime) ++realtimeAllocations;
+    if (void* memory = std::malloc(size > 0 ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void operator delete(void* memory) noexcept {
+    if (memory != nullptr && isCheckingRealtime) ++realtimeAllocations;
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept { operator delete(memory); }
+void operator delete(void* memory, std::size_t) noexcept { operator delete(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { operator delete(memory); }
+
+#if JUCE_LINUX
+// CriticalSection, WaitableEvent and std::mutex all end up here
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    // A plain static rather than a guarded local: the initialisation guard could itself lock
+    using LockFunction = int (*)(pthread_mutex_t*);
+    static LockFunction nextLock = nullptr;
+    if (nextLock == nullptr)
+        nextLock = reinterpret_cast<LockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+    if (isCheckingRealtime) ++realtimeLocks;
+    return nextLock(mutex);
+}
+#endif
+
+//==============================================================================
+// Reference model: one sample at a time, in double precision, no cursors or caches
+namespace reference {
+    struct Point { double time; double value; };
+    using Curve = std::vector<Point>;
+
+    // Linear interpolation holding the end values
+    double interpolate(const Curve& curve, double time) {
+        if (time <= curve.front().time) return curve.front().value;
+        if (time >= curve.back().time) return curve.back().value;
+        size_t i = 0;
+        while (curve[i + 1].time < time) ++i;
+        const double fraction = (time - curve[i].time) / (curve[i + 1].time - curve[i].time);
+        return curve[i].value + (curve[i + 1].value - curve[i].value) * fraction;
+    }
+
+    // lawMix 0 = linear, 1 = constant power
+    void panGains(double pan, double lawMix, double& left, double& right) {
+        const double linearLeft = 0.5 - 0.5 * pan;
+        const double linearRight = 0.5 + 0.5 * pan;
+        const double angle = pan * juce::MathConstants<double>::pi * 0.25;
+        const double powerLeft = std::sqrt(0.5) * (std::cos(angle) - std::sin(angle));
+        const double powerRight = std::sqrt(0.5) * (std::cos(angle) + std::sin(angle));
+        left = linearLeft + (powerLeft - linearLeft) * lawMix;
+        right = linearRight + (powerRight - linearRight) * lawMix;
+    }
+
+    // A linear ramp over a fixed number of samples towards the latest target, restarted from
+    // wherever it is when the target changes
+    struct Ramp {
+        int steps = 1;
+        double current = 0.0, target = 0.0, step = 0.0;
+        int remaining = 0;
+
+        void setTarget(double newTarget) {
+            if (newTarget == target) return;
+            target = newTarget;
+            remaining = steps;
+            step = (target - current) / steps;
+        }
+
+        double next() {
+            if (remaining > 0 && --remaining > 0)
+                current += step;
+            else
+                current = target;
+            return current;
+        }
+    };
+
+    enum class Sidechain { off, level, correlation };
+
+    struct Scene {
+        int numInputs = 2;
+        bool constantPower = true;
+        bool sync = true;          // the curve drives the pan (sync on, or note retrigger)
+        double parameterPan = 0.0;
+        Curve pan;
+        std::function<double(double)> panExpression;
+        Curve gain, width, law;
+        std::vector<Curve> objects; // an empty curve follows the main pan
+
+        // The stereo sidechain is read from the two channels after the main inputs
+        Sidechain sidechain = Sidechain::off;
+        double sidechainAmount = 0.0, attackMs = 10.0, releaseMs = 200.0;
+
+        std::vector<std::pair<int, double>> midiPanEvents; // (sample, pan) of each MIDI message that moves the pan
+        std::vector<int> noteOns;                          // samples; restart the curve when retriggering
+        bool retrigger = false;
+    };
+
+    void render(const Scene& scene, const juce::AudioBuffer<float>& input, double sampleRate,
+                std::vector<double>& left, std::vector<double>& right) {
+        const int numSamples = input.getNumSamples();
+        left.assign((size_t)numSamples, 0.0);
+        right.assign((size_t)numSamples, 0.0);
+
+        // The Pan parameter ramps in over 50 ms from 0; MIDI moves ramp over 5 ms from the current pan
+        Ramp parameterRamp{ static_cast<int>(std::floor(0.05 * sampleRate)) };
+        parameterRamp.setTarget(scene.parameterPan);
+        Ramp midiRamp{ static_cast<int>(std::floor(0.005 * sampleRate)) };
+        bool hasMidiPan = false;
+        size_t nextMidiPan = 0, nextNote = 0;
+        int curveStart = 0;
+
+        auto coefficient = [sampleRate](double ms) { return std::exp(-1000.0 / (juce::jmax(0.01, ms) * sampleRate)); };
+        const double attack = coefficient(scene.attackMs), release = coefficient(scene.releaseMs);
+        double envelope = 0.0, leftPower = 0.0, rightPower = 0.0, crossPower = 0.0;
+
+        for (int n = 0; n < numSamples; ++n) {
+            for (; nextNote < scene.noteOns.size() && scene.noteOns[nextNote] == n; ++nextNote) {
+                if (scene.retrigger) curveStart = n;
+            }
+            for (; nextMidiPan < scene.midiPanEvents.size() && scene.midiPanEvents[nextMidiPan].first == n; ++nextMidiPan) {
+                if (!hasMidiPan) {
+                    midiRamp.current = midiRamp.target = parameterRamp.current;
+                    midiRamp.remaining = 0;
+                }
+                midiRamp.setTarget(juce::jlimit(-1.0, 1.0, scene.midiPanEvents[nextMidiPan].second));
+                hasMidiPan = true;
+            }
+
+            const double t = (n - curveStart) / sampleRate;
+
+            double pan = scene.parameterPan;
+            if (!scene.sync)
+                pan = hasMidiPan ? midiRamp.next() : parameterRamp.next();
+            else if (scene.panExpression)
+                pan = juce::jlimit(-1.0, 1.0, scene.panExpression(t));
+            else if (!scene.pan.empty())
+                pan = interpolate(scene.pan, t);
+
+            if (scene.sidechain != Sidechain::off) {
+                const double l = input.getSample(scene.numInputs, n), r = input.getSample(scene.numInputs + 1, n);
+                double modulation = 0.0;
+                if (scene.sidechain == Sidechain::level) {
+                    // Mean of both rectified channels through an attack/release envelope
+                    const double rectified = 0.5 * (std::abs(l) + std::abs(r));
+                    envelope = rectified + (rectified > envelope ? attack : release) * (envelope - rectified);
+                    modulation = juce::jlimit(0.0, 1.0, envelope);
+                }
+                else {
+                    // Normalised cross-power, each power averaged over the release time
+                    leftPower = l * l + release * (leftPower - l * l);
+                    rightPower = r * r + release * (rightPower - r * r);
+                    crossPower = l * r + release * (crossPower - l * r);
+                    const double energy = std::sqrt(leftPower * rightPower);
+                    modulation = energy > 1.0e-9 ? juce::jlimit(-1.0, 1.0, crossPower / energy) : 0.0;
+                }
+                pan = juce::jlimit(-1.0, 1.0, pan + scene.sidechainAmount * modulation);
+            }
+
+            const double gain = scene.sync && !scene.gain.empty() ? interpolate(scene.gain, t) : 1.0;
+            const double lawMix = scene.sync && !scene.law.empty() ? interpolate(scene.law, t) : (scene.constantPower ? 1.0 : 0.0);
+            double leftGain, rightGain;
+
+            if (scene.numInputs > 2) {
+                for (int source = 0; source < scene.numInputs; ++source) {
+                    const bool hasLane = scene.sync && (size_t)source < scene.objects.size() && !scene.objects[(size_t)source].empty();
+                    panGains(hasLane ? interpolate(scene.objects[(size_t)source], t) : pan, lawMix, leftGain, rightGain);
+                    left[(size_t)n] += input.getSample(source, n) * leftGain * gain;
+                    right[(size_t)n] += input.getSample(source, n) * rightGain * gain;
+                }
+                continue;
+            }
+
+            panGains(pan, lawMix, leftGain, rightGain);
+
+            if (scene.numInputs == 1) {
+                left[(size_t)n] = input.getSample(0, n) * leftGain * gain;
+                right[(size_t)n] = input.getSample(0, n) * rightGain * gain;
+                continue;
+            }
+
+            double l = input.getSample(0, n), r = input.getSample(1, n);
+            if (scene.sync && !scene.width.empty()) {
+                const double mid = 0.5 * (l + r);
+                const double side = 0.5 * (l - r) * interpolate(scene.width, t);
+                l = mid + side;
+                r = mid - side;
+            }
+            left[(size_t)n] = l * leftGain * gain;
+            right[(size_t)n] = r * rightGain * gain;
+        }
+    }
+}
+
+//==============================================================================
+namespace {
+    struct Settings {
+        bool quick = false;
+        bool verbose = false;
+    };
+
+    class Results {
+    public:
+        explicit Results(const Settings& s) : settings(s) {}
+
+        void expect(const juce::String& name, bool passed, const juce::String& detail) {
+            if (!passed) ++failures;
+            ++cases;
+            if (!passed || settings.verbose)
+                std::cout << (passed ? "PASS " : "FAIL ") << name << "  " << detail << std::endl;
+        }
+
+        // 'locks' is -1 where they couldn't be counted
+        void check(const juce::String& name, double maxError, double bound, int allocations = 0, int locks = 0) {
+            const bool passed = maxError <= bound && allocations == 0 && locks <= 0;
+            if (!passed) ++failures;
+            ++cases;
+            if (locks < 0) ++locksNotChecked;
+
+            if (!passed || settings.verbose) {
+                std::cout << (passed ? "PASS " : "FAIL ") << name << "  max error " << juce::String(maxError, 9)
+                          << " (bound " << bound << ")";
+                if (allocations > 0) std::cout << ", " << allocations << " allocations";
+                if (locks > 0) std::cout << ", " << locks << " locks";
+                if (locks < 0) std::cout << ", locks not checked";
+                std::cout << std::endl;
+            }
+        }
+
+        int getFailures() const { return failures; }
+        int getCases() const { return cases; }
+        int getLocksNotChecked() const { return locksNotChecked; }
+
+    private:
+        const Settings& settings;
+        int failures = 0, cases = 0, locksNotChecked = 0;
+    };
+
+    void setParameter(PanningProcessor& processor, const char* id, float value) {
+        auto* parameter = processor.params.getParameter(id);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    void configure(PanningProcessor& processor, int numInputs, double sampleRate, int blockSize, bool constantPower, bool sync,
+                   bool stereoSidechain = false) {
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(numInputs == 1 ? juce::AudioChannelSet::mono()
+                            : numInputs == 2 ? juce::AudioChannelSet::stereo()
+                                             : juce::AudioChannelSet::discreteChannels(numInputs));
+        layout.inputBuses.add(stereoSidechain ? juce::AudioChannelSet::stereo() : juce::AudioChannelSet::disabled());
+        layout.outputBuses.add(juce::AudioChannelSet::stereo());
+        processor.setBusesLayout(layout);
+
+        setParameter(processor, "law", constantPower ? 1.0f : 0.0f);
+        setParameter(processor, "sync", sync ? 1.0f : 0.0f);
+        setParameter(processor, "pan", 0.35f);
+        processor.setNonRealtime(false);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+
+    // A different tone plus noise on every channel, so swapped or dropped channels show up
+    juce::AudioBuffer<float> makeSignal(int numChannels, int numSamples, double sampleRate) {
+        juce::AudioBuffer<float> signal(numChannels, numSamples);
+        juce::Random random(1234);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const double frequency = 110.0 * (ch + 1);
+            for (int i = 0; i < numSamples; ++i) {
+                const double tone = std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate);
+                signal.setSample(ch, i, static_cast<float>(0.6 * tone) + 0.3f * (random.nextFloat() * 2.0f - 1.0f));
+            }
+        }
+        return signal;
+    }
+
+    struct CurveCase {
+        const char* name;
+        juce::String text;
+        std::function<void(reference::Scene&)> describe;
+    };
+
+    std::vector<CurveCase> makeCurveCases() {
+        return {
+            { "table", "0.0 -1.0\n1.5 0.8\n2.5 -0.3\n4.0 1.0\n",
+              [](reference::Scene& scene) { scene.pan = { { 0.0, -1.0 }, { 1.5, 0.8 }, { 2.5, -0.3 }, { 4.0, 1.0 } }; } },
+            { "expression", "pan = 1.2*sin(2*pi*0.5*t)\n",
+              [](reference::Scene& scene) {
+                  scene.panExpression = [](double t) { return 1.2 * std::sin(juce::MathConstants<double>::twoPi * 0.5 * t); };
+              } },
+            { "lanes", "time,pan,gain,width,law\n0,-1,1,1,1\n2,1,0.5,0,0\n4,0,2,2,0.5\n",
+              [](reference::Scene& scene) {
+                  scene.pan = { { 0.0, -1.0 }, { 2.0, 1.0 }, { 4.0, 0.0 } };
+                  scene.gain = { { 0.0, 1.0 }, { 2.0, 0.5 }, { 4.0, 2.0 } };
+                  scene.width = { { 0.0, 1.0 }, { 2.0, 0.0 }, { 4.0, 2.0 } };
+                  scene.law = { { 0.0, 1.0 }, { 2.0, 0.0 }, { 4.0, 0.5 } };
+              } },
+            // Headerless files are "time pan" only; older files with trailing columns must not gain lanes
+            { "headerless", "0.0 -1.0 0.25 0\n4.0 1.0 3 2\n",
+              [](reference::Scene& scene) { scene.pan = { { 0.0, -1.0 }, { 4.0, 1.0 } }; } },
+            { "objects", "# columns: time pan law obj1 obj2 obj3\n0 0.5 1 -1 0 1\n4 -0.5 0 1 0.5 -1\n",
+              [](reference::Scene& scene) {
+                  scene.pan = { { 0.0, 0.5 }, { 4.0, -0.5 } };
+                  scene.law = { { 0.0, 1.0 }, { 4.0, 0.0 } };
+                  scene.objects = { { { 0.0, -1.0 }, { 4.0, 1.0 } }, { { 0.0, 0.0 }, { 4.0, 0.5 } }, { { 0.0, 1.0 }, { 4.0, -1.0 } } };
+              } }
+        };
+    }
+
+    // Renders 'input' through processBlock with a cycle of irregular block sizes, as some hosts deliver
+    // them. 'events' are at absolute sample positions and handed to the block they fall in.
+    void renderProcessor(PanningProcessor& processor, const juce::AudioBuffer<float>& input, int blockSize, bool lookahead,
+                         juce::AudioBuffer<float>& output, int& allocations, int& locks, const juce::MidiBuffer& events = {}) {
+        const int numSamples = input.getNumSamples();
+        const int sizes[] = { blockSize, blockSize / 3 + 1, 1, blockSize - 7 };
+        juce::AudioBuffer<float> block(juce::jmax(2, input.getNumChannels()), blockSize);
+        juce::MidiBuffer midi;
+        output.setSize(2, numSamples);
+
+        realtimeAllocations = 0;
+        realtimeLocks = 0;
+        for (int position = 0, call = 0; position < numSamples; ++call) {
+            const int num = juce::jmin(juce::jmax(1, sizes[call % 4]), numSamples - position);
+            block.setSize(block.getNumChannels(), num, false, false, true);
+            for (int ch = 0; ch < input.getNumChannels(); ++ch)
+                block.copyFrom(ch, 0, input, ch, position, num);
+            midi.clear();
+            for (const auto event : events) {
+                if (event.samplePosition >= position && event.samplePosition < position + num)
+                    midi.addEvent(event.getMessage(), event.samplePosition - position);
+            }
+
+            {
+                ScopedRealtimeCheck check;
+                processor.processBlock(block, midi);
+            }
+
+            output.copyFrom(0, position, block, 0, 0, num);
+            output.copyFrom(1, position, block, 1, 0, num);
+            position += num;
+
+            // Give the lookahead worker a chance to get ahead, as it would in real time
+            if (lookahead) juce::Thread::sleep(1);
+        }
+        allocations = realtimeAllocations.load();
+        locks = canCountLocks ? realtimeLocks.load() : -1;
+    }
+
+    double maxDifference(const juce::AudioBuffer<float>& output, const std::vector<double>& left, const std::vector<double>& right) {
+        double largest = 0.0;
+        for (int i = 0; i < output.getNumSamples(); ++i) {
+            largest = juce::jmax(largest, std::abs(output.getSample(0, i) - left[(size_t)i]),
+                                 std::abs(output.getSample(1, i) - right[(size_t)i]));
+        }
+        return largest;
+    }
+
+    void verifyProcessBlock(Results& results, const Settings& settings) {
+        const std::vector<double> sampleRates = settings.quick ? std::vector<double>{ 48000.0 } : std::vector<double>{ 44100.0, 96000.0 };
+        const std::vector<int> blockSizes = settings.quick ? std::vector<int>{ 256 } : std::vector<int>{ 64, 512 };
+        const auto curveCases = makeCurveCases();
+
+        for (int numInputs : { 1, 2, 4 }) {
+            for (bool constantPower : { false, true }) {
+                for (double sampleRate : sampleRates) {
+                    const auto input = makeSignal(numInputs, static_cast<int>(4.5 * sampleRate), sampleRate);
+
+                    for (int blockSize : blockSizes) {
+                        // Sync off plus one run per curve type; object files only make sense with >2 inputs
+                        for (int curve = -1; curve < (int)curveCases.size(); ++curve) {
+                            const bool sync = curve >= 0;
+                            if (sync && (curveCases[(size_t)curve].name == juce::String("objects")) != (numInputs > 2))
+                                continue;
+
+                            for (bool lookahead : { false, true }) {
+                                // Lookahead only prefetches mono/stereo curves; one block size and rate keeps it quick
+                                if (lookahead && (!sync || numInputs > 2 || blockSize != blockSizes.back() || sampleRate != sampleRates.front()))
+                                    continue;
+
+                                PanningProcessor processor;
+                                reference::Scene scene;
+                                scene.numInputs = numInputs;
+                                scene.constantPower = constantPower;
+                                scene.sync = sync;
+                                if (sync) {
+                                    processor.setBreakpointText(curveCases[(size_t)curve].text);
+                                    curveCases[(size_t)curve].describe(scene);
+                                }
+                                processor.setLookaheadRendering(lookahead);
+                                configure(processor, numInputs, sampleRate, blockSize, constantPower, sync);
+                                scene.parameterPan = processor.params.getRawParameterValue("pan")->load();
+
+                                juce::AudioBuffer<float> output;
+                                int allocations = 0, locks = 0;
+                                renderProcessor(processor, input, blockSize, lookahead, output, allocations, locks);
+                                const auto prefetchedBlocks = processor.getNumPrefetchedBlocks();
+                                processor.releaseResources();
+
+                                std::vector<double> left, right;
+                                reference::render(scene, input, sampleRate, left, right);
+
+                                // Objects ramp their gains between control points every 32 samples
+                                const double bound = numInputs > 2 ? 5.0e-4 : 2.0e-5;
+                                const auto name = juce::String("processBlock inputs=") + juce::String(numInputs)
+                                                + " law=" + (constantPower ? "power" : "linear")
+                                                + " source=" + (sync ? curveCases[(size_t)curve].name : "parameter")
+                                                + " rate=" + juce::String(sampleRate, 0) + " block=" + juce::String(blockSize)
+                                                + (lookahead ? " lookahead" : "");
+                                results.check(name, maxDifference(output, left, right), bound, allocations, locks);
+
+                                // Without this the lookahead cases could pass on the inline path alone.
+                                // A width lane keeps the curve inline, so the lanes case is exempt.
+                                if (lookahead && scene.width.empty())
+                                    results.expect(name + " prefetched", prefetchedBlocks > 0,
+                                                   juce::String(prefetchedBlocks) + " blocks served from the lookahead ring");
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    struct ModulationCase {
+        const char* name;
+        bool sync;
+        std::function<void(PanningProcessor&, reference::Scene&, juce::MidiBuffer&, double sampleRate)> setUp;
+    };
+
+    // Sidechain modulation, MIDI control and note retrigger on a stereo input, each against the reference
+    void verifyModulation(Results& results, const Settings& settings) {
+        const double sampleRate = 48000.0;
+        const std::vector<int> blockSizes = settings.quick ? std::vector<int>{ 256 } : std::vector<int>{ 64, 512 };
+        const juce::String curveText = "0.0 -1.0\n1.5 0.8\n2.5 -0.3\n4.0 1.0\n";
+        const reference::Curve curve = { { 0.0, -1.0 }, { 1.5, 0.8 }, { 2.5, -0.3 }, { 4.0, 1.0 } };
+
+        auto useSidechain = [&](reference::Sidechain mode) {
+            return [&, mode](PanningProcessor& processor, reference::Scene& scene, juce::MidiBuffer&, double) {
+                processor.setBreakpointText(curveText);
+                setParameter(processor, "scmode", static_cast<float>(static_cast<int>(mode)));
+                setParameter(processor, "scamount", 0.6f);
+                scene.pan = curve;
+                scene.sidechain = mode;
+            };
+        };
+
+        const std::vector<ModulationCase> cases {
+            { "sidechain=level", true, useSidechain(reference::Sidechain::level) },
+            { "sidechain=correlation", true, useSidechain(reference::Sidechain::correlation) },
+            { "midi=controller", false, [](PanningProcessor& processor, reference::Scene& scene, juce::MidiBuffer& events, double rate) {
+                  // Moves closer together than the 5 ms ramp, a value clamped at -1 and other controllers that must be ignored
+                  setParameter(processor, "midimode", 1.0f);
+                  const std::pair<double, int> moves[] = { { 0.01, 100 }, { 0.5, 20 }, { 0.502, 90 }, { 1.3, 0 }, { 2.0001, 127 }, { 3.7, 64 } };
+                  for (const auto& move : moves) {
+                      const int position = static_cast<int>(move.first * rate);
+                      events.addEvent(juce::MidiMessage::controllerEvent(1, 10, move.second), position);
+                      events.addEvent(juce::MidiMessage::controllerEvent(1, 11, 127 - move.second), position + 3);
+                      scene.midiPanEvents.push_back({ position, (move.second - 64) / 63.0 });
+                  }
+              } },
+            { "midi=mpe", false, [](PanningProcessor& processor, reference::Scene& scene, juce::MidiBuffer& events, double rate) {
+                  // Bends on the newest note's channel steer; one sent at the same sample just before its note-on counts
+                  setParameter(processor, "midimode", 2.0f);
+                  struct Move { double time; int channel, bend; bool withNote, follows; };
+                  const Move moves[] = { { 0.3, 2, 12000, true, true }, { 1.1, 3, 4000, false, false }, { 1.6, 2, 2000, false, true },
+                                         { 2.4, 3, 16383, true, true }, { 3.0, 2, 9000, false, false }, { 3.5, 3, 0, false, true } };
+                  for (const auto& move : moves) {
+                      const int position = static_cast<int>(move.time * rate);
+                      events.addEvent(juce::MidiMessage::pitchWheel(move.channel, move.bend), position);
+                      if (move.withNote)
+                          events.addEvent(juce::MidiMessage::noteOn(move.channel, 60, 0.8f), position);
+                      if (move.follows)
+                          scene.midiPanEvents.push_back({ position, (move.bend - 8192) / 8191.0 });
+                  }
+              } },
+            { "retrigger", false, [&](PanningProcessor& processor, reference::Scene& scene, juce::MidiBuffer& events, double rate) {
+                  // Sync is off: the retrigger alone runs the curve, from zero at each note-on
+                  processor.setBreakpointText(curveText);
+                  setParameter(processor, "noteretrigger", 1.0f);
+                  scene.pan = curve;
+                  scene.sync = scene.retrigger = true;
+                  for (double time : { 0.7, 1.9, 1.95, 3.1 }) {
+                      const int position = static_cast<int>(time * rate);
+                      events.addEvent(juce::MidiMessage::noteOn(1, 60, 0.8f), position);
+                      events.addEvent(juce::MidiMessage::noteOff(1, 60), position + 2000);
+                      scene.noteOns.push_back(position);
+                  }
+              } }
+        };
+
+        for (const auto& modulationCase : cases) {
+            const bool sidechain = juce::String(modulationCase.name).startsWith("sidechain");
+            const auto input = makeSignal(sidechain ? 4 : 2, static_cast<int>(4.5 * sampleRate), sampleRate);
+
+            for (bool constantPower : { false, true }) {
+                for (int blockSize : blockSizes) {
+                    PanningProcessor processor;
+                    reference::Scene scene;
+                    scene.constantPower = constantPower;
+                    scene.sync = modulationCase.sync;
+                    juce::MidiBuffer events;
+                    configure(processor, 2, sampleRate, blockSize, constantPower, modulationCase.sync, sidechain);
+                    modulationCase.setUp(processor, scene, events, sampleRate);
+                    scene.parameterPan = processor.params.getRawParameterValue("pan")->load();
+                    scene.attackMs = processor.params.getRawParameterValue("scattack")->load();
+                    scene.releaseMs = processor.params.getRawParameterValue("screlease")->load();
+                    scene.sidechainAmount = processor.params.getRawParameterValue("scamount")->load();
+
+                    juce::AudioBuffer<float> output;
+                    int allocations = 0, locks = 0;
+                    renderProcessor(processor, input, blockSize, false, output, allocations, locks, events);
+                    processor.releaseResources();
+
+                    std::vector<double> left, right;
+                    reference::render(scene, input, sampleRate, left, right);
+
+                    // The followers keep single-precision state through long one-pole averages
+                    const double bound = sidechain ? 2.0e-4 : 2.0e-5;
+                    results.check(juce::String("processBlock ") + modulationCase.name + " law=" + (constantPower ? "power" : "linear")
+                                      + " block=" + juce::String(blockSize),
+                                  maxDifference(output, left, right), bound, allocations, locks);
+                }
+            }
+        }
+    }
+
+    void verifyPanLaws(Results& results) {
+        PanningProcessor processor;
+        constexpr int numPositions = 200001;
+        double linearError = 0.0, powerError = 0.0;
+
+        for (int i = 0; i < numPositions; ++i) {
+            const float position = -1.0f + 2.0f * static_cast<float>(i) / (numPositions - 1);
+            double left, right;
+
+            reference::panGains(position, 0.0, left, right);
+            auto linear = processor.linearPan(position);
+            linearError = juce::jmax(linearError, std::abs(linear.left - left), std::abs(linear.right - right));
+
+            reference::panGains(position, 1.0, left, right);
+            auto power = processor.constantPowerPan(position);
+            powerError = juce::jmax(powerError, std::abs(power.left - left), std::abs(power.right - right));
+        }
+
+        results.check("linearPan", linearError, 1.0e-6);
+        results.check("constantPowerPan", powerError, 1.0e-6);
+    }
+
+    void verifyBreakpointLookup(Results& results) {
+        constexpr double duration = 60.0;
+        juce::Random random(42);
+        reference::Curve curve;
+        juce::MemoryOutputStream text;
+
+        // Uneven spacing so the search can't rely on a fixed step
+        double time = 0.0;
+        while (time < duration) {
+            const double value = random.nextDouble() * 2.0 - 1.0;
+            curve.push_back({ time, value });
+            text << juce::String(time, 9) << " " << juce::String(value, 9) << "\n";
+            time += 0.001 + random.nextDouble() * 0.02;
+        }
+
+        PanningProcessor processor;
+        processor.setBreakpointText(text.toString());
+
+        // Reference values come from the same decimal text the processor parsed
+        for (auto& point : curve) {
+            point.time = juce::String(point.time, 9).getDoubleValue();
+            point.value = juce::String(point.value, 9).getDoubleValue();
+        }
+
+        double sequentialError = 0.0;
+        for (double t = 0.0; t < duration + 0.5; t += 1.0 / 48000.0)
+            sequentialError = juce::jmax(sequentialError, std::abs(processor.getBreakpointValue(t) - reference::interpolate(curve, t)));
+
+        double randomError = 0.0;
+        for (int i = 0; i < 100000; ++i) {
+            const double t = random.nextDouble() * (duration + 0.5);
+            randomError = juce::jmax(randomError, std::abs(processor.getBreakpointValue(t) - reference::interpolate(curve, t)));
+        }
+
+        results.check("getBreakpointValue_sequential", sequentialError, 1.0e-6);
+        results.check("getBreakpointValue_random", randomError, 1.0e-6);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    Settings settings;
+    settings.quick = args.containsOption("--quick");
+    settings.verbose = args.containsOption("--verbose");
+
+    Results results(settings);
+    verifyPanLaws(results);
+    verifyBreakpointLookup(results);
+    verifyProcessBlock(results, settings);
+    verifyModulation(results, settings);
+
+    if (results.getLocksNotChecked() > 0)
+        std::cout << "Audio-thread mutex locks: not checked on this platform (" << results.getLocksNotChecked()
+                  << " cases); only the Linux build can count them" << std::endl;
+    std::cout << results.getCases() - results.getFailures() << " of " << results.getCases() << " cases passed" << std::endl;
+    return results.getFailures() > 0 ? 1 : 0;
+}